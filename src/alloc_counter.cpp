@@ -0,0 +1,130 @@
+/**
+ * @file alloc_counter.cpp
+ *
+ * @brief Replacement of the global allocation functions that counts calls.
+ *
+ * All forms of `operator new` end up in the plain and the aligned one, so
+ * only those two and their `operator delete` counterparts are replaced.
+ * With `PLOTTINGS_ALLOC_CHECK` it also keeps the allocation scopes and
+ * prints their report at exit.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> allocations{0};
+/* Trivially constructed, so `operator new` may use them at any time. */
+thread_local uint64_t thread_allocations = 0;
+/** Open `alloc_check::Uncounted` scopes of the thread. */
+thread_local uint32_t uncounted_depth = 0;
+
+void count_allocation() {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (uncounted_depth == 0) {
+    thread_allocations++;
+  }
+}
+} // namespace
+
+uint64_t allocation_count() {
+  return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t thread_allocation_count() { return thread_allocations; }
+
+#if defined(PLOTTINGS_ALLOC_CHECK) && PLOTTINGS_ALLOC_CHECK > 0
+namespace {
+/** All sites. Prints the report when destroyed at exit. The sites are
+ * trivially destructible and outlive it in practice. */
+class Registry {
+public:
+  ~Registry() {
+    std::fprintf(stderr, "%-40s %12s %14s %10s %12s\n", "allocation scope",
+                 "entries", "allocations", "per entry", "violations");
+    for (const alloc_check::Site *site = sites; site != nullptr;
+         site = site->next) {
+      const uint64_t entries = site->entries.load();
+      const uint64_t count = site->allocations.load();
+      std::fprintf(stderr, "%-40s %12llu %14llu %10.2f %12llu\n", site->name,
+                   static_cast<unsigned long long>(entries),
+                   static_cast<unsigned long long>(count),
+                   entries > 0 ? static_cast<double>(count) /
+                                     static_cast<double>(entries)
+                               : 0.0,
+                   static_cast<unsigned long long>(site->violations.load()));
+    }
+  }
+
+  void Add(alloc_check::Site *site) {
+    const std::lock_guard lock(mutex);
+    site->next = sites;
+    sites = site;
+  }
+
+private:
+  std::mutex mutex{};
+  const alloc_check::Site *sites{nullptr};
+};
+
+Registry &registry() {
+  static Registry registry{};
+  return registry;
+}
+} // namespace
+
+namespace alloc_check {
+Site::Site(const char *name) : name(name) { registry().Add(this); }
+
+void Violation(Site &site, uint64_t allocations) {
+  site.violations.fetch_add(1, std::memory_order_relaxed);
+#if PLOTTINGS_ALLOC_CHECK > 1
+  std::fprintf(stderr, "%llu allocation(s) in allocation-free scope '%s'\n",
+               static_cast<unsigned long long>(allocations), site.name);
+  std::abort();
+#else
+  static_cast<void>(allocations);
+#endif
+}
+
+Uncounted::Uncounted() { uncounted_depth++; }
+
+Uncounted::~Uncounted() { uncounted_depth--; }
+} // namespace alloc_check
+#endif
+
+void *operator new(std::size_t size) {
+  count_allocation();
+  if (void *p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  count_allocation();
+  const auto align = static_cast<std::size_t>(alignment);
+  /* aligned_alloc wants a multiple of the alignment. */
+  const std::size_t rounded = (size + align - 1) / align * align;
+  if (void *p = std::aligned_alloc(align, rounded == 0 ? align : rounded)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
@@ -0,0 +1,117 @@
+#ifndef ALLOC_COUNTER_H_
+#define ALLOC_COUNTER_H_
+/**
+ * @file alloc_counter.hpp
+ *
+ * @brief Count heap allocations of the whole process.
+ *
+ * alloc_counter.cpp replaces the global `operator new`. Only executables
+ * that compile it in count anything, e.g. the benchmarks. In all others
+ * the count stays zero.
+ *
+ * # Allocation scopes
+ *
+ * Built with `-DPLOTTINGS_ALLOC_CHECK=1` (or the CMake cache variable of the
+ * same name) the scope macros below count the allocations of the calling
+ * thread per place in the source and print a table at exit. With
+ * `PLOTTINGS_ALLOC_CHECK=2` an allocation inside an allocation-free scope
+ * aborts the process with the scope name, so a replay or benchmark run
+ * fails on the first one. Otherwise the macros expand to nothing.
+ *
+ * - `ALLOC_SCOPE(name)` counts until the end of the enclosing block.
+ * - `ALLOC_FREE_SCOPE(name)` counts and must not allocate.
+ * - `ALLOC_FREE_SCOPE_IF(name, predicate)` must not allocate if
+ * `predicate()` is 'true' at the end of the block.
+ * - `ALLOC_UNCOUNTED_SCOPE()` hides the allocations of the calling thread
+ * from all scopes until the end of the enclosing block. For
+ * instrumentation such as tracing, whose buffers grow wherever it records.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <cstdint>
+
+/** Number of calls to the global `operator new` so far, all threads. */
+[[nodiscard]] uint64_t allocation_count();
+
+/** Number of calls to the global `operator new` by the calling thread. */
+[[nodiscard]] uint64_t thread_allocation_count();
+
+#if defined(PLOTTINGS_ALLOC_CHECK) && PLOTTINGS_ALLOC_CHECK > 0
+#include <atomic>
+
+namespace alloc_check {
+/** Totals of one scope in the source. Registered for the exit report on
+ * construction. */
+struct Site {
+  explicit Site(const char *name);
+
+  const char *name;
+  std::atomic<uint64_t> entries{0};
+  std::atomic<uint64_t> allocations{0};
+  /** Entries of an allocation-free scope that allocated anyway. */
+  std::atomic<uint64_t> violations{0};
+  /** Intrusive list of all sites, so registering does not allocate. */
+  const Site *next{nullptr};
+};
+
+/** Count `allocations` in an allocation-free `site`. Aborts with
+ * `PLOTTINGS_ALLOC_CHECK=2`. */
+void Violation(Site &site, uint64_t allocations);
+
+/** Allocations of the calling thread do not count towards
+ * `thread_allocation_count()` while an instance exists. Nests. */
+class Uncounted {
+public:
+  Uncounted();
+  ~Uncounted();
+
+  Uncounted(const Uncounted &) = delete;
+  Uncounted &operator=(const Uncounted &) = delete;
+};
+
+/** Adds the allocations of the calling thread during its lifetime to a
+ * `Site`. */
+template <typename Enforce> class Guard {
+public:
+  Guard(Site &site, Enforce enforce)
+      : site(site), enforce(enforce), start(thread_allocation_count()) {}
+
+  ~Guard() {
+    const uint64_t allocations = thread_allocation_count() - start;
+    site.entries.fetch_add(1, std::memory_order_relaxed);
+    site.allocations.fetch_add(allocations, std::memory_order_relaxed);
+    if (allocations > 0 && enforce()) {
+      Violation(site, allocations);
+    }
+  }
+
+  Guard(const Guard &) = delete;
+  Guard &operator=(const Guard &) = delete;
+
+private:
+  Site &site;
+  Enforce enforce;
+  uint64_t start;
+};
+} // namespace alloc_check
+
+#define ALLOC_CONCAT_(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_(a, b)
+#define ALLOC_FREE_SCOPE_IF(name, predicate)                                   \
+  static alloc_check::Site ALLOC_CONCAT(alloc_site_, __LINE__){name};          \
+  const alloc_check::Guard ALLOC_CONCAT(alloc_guard_, __LINE__) {              \
+    ALLOC_CONCAT(alloc_site_, __LINE__), predicate                             \
+  }
+#define ALLOC_SCOPE(name) ALLOC_FREE_SCOPE_IF(name, [] { return false; })
+#define ALLOC_FREE_SCOPE(name) ALLOC_FREE_SCOPE_IF(name, [] { return true; })
+#define ALLOC_UNCOUNTED_SCOPE()                                                \
+  const alloc_check::Uncounted ALLOC_CONCAT(alloc_uncounted_, __LINE__) {}
+#else
+#define ALLOC_SCOPE(name) static_cast<void>(0)
+#define ALLOC_FREE_SCOPE(name) static_cast<void>(0)
+#define ALLOC_FREE_SCOPE_IF(name, predicate) static_cast<void>(0)
+#define ALLOC_UNCOUNTED_SCOPE() static_cast<void>(0)
+#endif
+
+#endif // ALLOC_COUNTER_H_
@@ -0,0 +1,151 @@
+/**
+ * @file basin_map.cpp
+ *
+ * @brief Parallel computation of the basin-of-attraction map.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "basin_map.hpp"
+#include "heatmap_file.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+BasinMap::BasinMap(ThreadPool &pool, const HeatmapGrid &grid,
+                   FunctionPtr<2> funktion, double step_size,
+                   std::size_t max_iterations)
+    : grid_(grid), max_iterations_(max_iterations),
+      shared(std::make_shared<Shared>()),
+      labels_(grid.resolution * grid.resolution, PENDING),
+      iterations_(grid.resolution * grid.resolution, 0),
+      evaluations_(grid.resolution * grid.resolution, 0) {
+  for (std::size_t row = 0; row < grid.resolution; row += TILE_SIZE) {
+    for (std::size_t column = 0; column < grid.resolution;
+         column += TILE_SIZE) {
+      Tile tile{};
+      tile.row = row;
+      tile.column = column;
+      tile.rows = std::min(TILE_SIZE, grid.resolution - row);
+      tile.columns = std::min(TILE_SIZE, grid.resolution - column);
+      tiles_total_++;
+
+      pool.Submit([shared = shared, tile = std::move(tile), grid, funktion,
+                   step_size, max_iterations]() mutable {
+        if (shared->cancelled) {
+          return;
+        }
+        TRACE_SCOPE("BasinMap tile");
+        tile.ends.reserve(tile.rows * tile.columns);
+        tile.converged.reserve(tile.rows * tile.columns);
+        tile.iterations.reserve(tile.rows * tile.columns);
+        for (std::size_t r = tile.row; r < tile.row + tile.rows; r++) {
+          for (std::size_t c = tile.column; c < tile.column + tile.columns;
+               c++) {
+            auto iteration = IterationData<2>::AtPoint(grid.position(r, c),
+                                                       funktion, step_size, 0);
+            while (!iteration.done(max_iterations)) {
+              iteration = IterationData<2>::Next(iteration);
+            }
+            tile.ends.push_back(iteration.current);
+            tile.converged.push_back(iteration.current_grad.norm() <
+                                     IterationData<2>::GRAD_LIMIT);
+            tile.iterations.push_back(
+                static_cast<uint32_t>(iteration.index));
+          }
+        }
+        const std::lock_guard lock(shared->mutex);
+        shared->finished.push_back(std::move(tile));
+      });
+    }
+  }
+}
+
+BasinMap::~BasinMap() { shared->cancelled = true; }
+
+int32_t BasinMap::label(const Point<2> &end) {
+  for (std::size_t i = 0; i < optima_.size(); i++) {
+    if ((end.vector + -1.0 * optima_[i].vector).norm() < OPTIMUM_TOLERANCE) {
+      return static_cast<int32_t>(i);
+    }
+  }
+  optima_.push_back(end);
+  return static_cast<int32_t>(optima_.size() - 1);
+}
+
+bool BasinMap::Poll() {
+  std::vector<Tile> tiles;
+  {
+    const std::lock_guard lock(shared->mutex);
+    tiles.swap(shared->finished);
+  }
+  for (const Tile &tile : tiles) {
+    std::size_t i = 0;
+    for (std::size_t r = tile.row; r < tile.row + tile.rows; r++) {
+      for (std::size_t c = tile.column; c < tile.column + tile.columns;
+           c++, i++) {
+        const std::size_t cell = r * grid_.resolution + c;
+        labels_[cell] = tile.converged[i] ? label(tile.ends[i]) : NOT_CONVERGED;
+        /* The first iteration is evaluated too. */
+        iterations_[cell] = tile.iterations[i];
+        evaluations_[cell] =
+            (static_cast<double>(tile.iterations[i]) + 1.0) *
+            IterationData<2>::EVALUATIONS_PER_ITERATION;
+        max_iterations_used_ =
+            std::max(max_iterations_used_, iterations_[cell]);
+        limit_hits_ += tile.iterations[i] >= max_iterations_;
+      }
+    }
+    cells_done_ += tile.rows * tile.columns;
+  }
+  tiles_done_ += tiles.size();
+  return !tiles.empty();
+}
+
+int32_t BasinMap::LabelAt(const CMyVektor<2> &x) const {
+  if (!grid_.contains(x) || grid_.resolution == 0) {
+    return PENDING;
+  }
+  const double last = static_cast<double>(grid_.resolution - 1);
+  /* Nearest sample, rows count down from the top edge. */
+  const auto column = static_cast<std::size_t>(
+      std::clamp(std::round((x[0] - grid_.x_min) / grid_.tick()), 0.0, last));
+  const auto row = static_cast<std::size_t>(std::clamp(
+      std::round((grid_.y_min + grid_.size - x[1]) / grid_.tick()), 0.0,
+      last));
+  return labels_[row * grid_.resolution + column];
+}
+
+BasinMap &BasinMapCache::Get(ThreadPool &pool, const HeatmapGrid &grid,
+                             FunctionPtr<2> funktion, double step_size,
+                             std::size_t max_iterations) {
+  const uint64_t fingerprint = function_fingerprint(funktion);
+  clock++;
+  for (auto &entry : entries) {
+    if (entry.fingerprint == fingerprint &&
+        entry.grid.resolution == grid.resolution &&
+        entry.grid.x_min == grid.x_min && entry.grid.y_min == grid.y_min &&
+        entry.grid.size == grid.size && entry.step_size == step_size &&
+        entry.max_iterations == max_iterations) {
+      entry.used = clock;
+      return *entry.map;
+    }
+  }
+
+  if (entries.size() >= capacity) {
+    const auto oldest = std::min_element(
+        entries.begin(), entries.end(),
+        [](const Entry &a, const Entry &b) { return a.used < b.used; });
+    entries.erase(oldest);
+  }
+  Entry &entry = entries.emplace_back();
+  entry.fingerprint = fingerprint;
+  entry.grid = grid;
+  entry.step_size = step_size;
+  entry.max_iterations = max_iterations;
+  entry.map = std::make_unique<BasinMap>(pool, grid, funktion, step_size,
+                                         max_iterations);
+  entry.used = clock;
+  return *entry.map;
+}
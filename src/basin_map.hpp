@@ -0,0 +1,182 @@
+#ifndef BASIN_MAP_H_
+#define BASIN_MAP_H_
+/**
+ * @file basin_map.hpp
+ *
+ * @brief Basin-of-attraction and convergence-cost map: the optimum gradient
+ * descent converges to from every cell of a grid, and how many iterations
+ * and objective evaluations it takes to get there.
+ *
+ * Every cell is an independent optimization run, so the grid is split into
+ * square tiles that are computed on a `ThreadPool`. Finished tiles are
+ * collected by `Poll()` on the caller's thread, which keeps the labels
+ * readable without locking while the rest is still being computed.
+ *
+ * End points closer than `OPTIMUM_TOLERANCE` to each other count as the same
+ * optimum. Runs that hit the iteration limit before the gradient vanished
+ * are labelled `NOT_CONVERGED`.
+ *
+ * `BasinMapCache` keeps finished maps by objective and options, so switching
+ * back to earlier settings does not compute them again.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "heatmap.hpp"
+#include "iteration.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/** Optimum reached from every cell of a grid and the cost to reach it. */
+class BasinMap {
+public:
+  /** Label of cells that have not been computed yet. */
+  static constexpr int32_t PENDING = -2;
+
+  /** Label of cells whose run did not converge. */
+  static constexpr int32_t NOT_CONVERGED = -1;
+
+  /** Tile width and height in cells. */
+  static constexpr std::size_t TILE_SIZE = 16;
+
+  /** Maximum distance of end points that belong to the same optimum. */
+  static constexpr double OPTIMUM_TOLERANCE = 1.0e-2;
+
+  /**
+   * Queue all tiles on `pool`. The tiles run gradient descent with the given
+   * parameters from `grid.position(row, column)` of every cell.
+   */
+  BasinMap(ThreadPool &pool, const HeatmapGrid &grid, FunctionPtr<2> funktion,
+           double step_size, std::size_t max_iterations);
+
+  /** Cancels tiles that have not started yet. */
+  ~BasinMap();
+
+  BasinMap(const BasinMap &) = delete;
+  BasinMap &operator=(const BasinMap &) = delete;
+
+  /**
+   * Collect finished tiles and label their cells.
+   *
+   * @returns 'true' if any label changed.
+   */
+  bool Poll();
+
+  /** Cell labels, row-major, top row first. Index into `optima()`, or
+   * `PENDING` or `NOT_CONVERGED`. */
+  [[nodiscard]] const std::vector<int32_t> &labels() const { return labels_; }
+
+  /** Iterations until `done()` per cell, row-major. Zero while pending. */
+  [[nodiscard]] const std::vector<uint32_t> &iterations() const {
+    return iterations_;
+  }
+
+  /** Objective evaluations per cell, row-major. Zero while pending. Stored
+   * as double, which counts exactly far beyond any iteration limit and plots
+   * like the other heatmaps. */
+  [[nodiscard]] const std::vector<double> &evaluations() const {
+    return evaluations_;
+  }
+
+  /** Largest value in `iterations()`. */
+  [[nodiscard]] uint32_t max_iterations_used() const {
+    return max_iterations_used_;
+  }
+
+  /** Number of finished cells whose run hit the iteration limit. */
+  [[nodiscard]] std::size_t limit_hits() const { return limit_hits_; }
+
+  /** Number of finished cells. */
+  [[nodiscard]] std::size_t cells_done() const { return cells_done_; }
+
+  /** Distinct optima found so far, in order of discovery. */
+  [[nodiscard]] const std::vector<Point<2>> &optima() const { return optima_; }
+
+  /** Label of the cell sampled nearest to `x`. `PENDING` outside of the
+   * grid. */
+  [[nodiscard]] int32_t LabelAt(const CMyVektor<2> &x) const;
+
+  [[nodiscard]] const HeatmapGrid &grid() const { return grid_; }
+  [[nodiscard]] std::size_t max_iterations() const { return max_iterations_; }
+
+  /** Number of finished and total tiles. */
+  [[nodiscard]] std::size_t tiles_done() const { return tiles_done_; }
+  [[nodiscard]] std::size_t tiles_total() const { return tiles_total_; }
+  [[nodiscard]] bool finished() const { return tiles_done_ == tiles_total_; }
+
+private:
+  /** End points of one tile, computed on a worker. */
+  struct Tile {
+    std::size_t row{};
+    std::size_t column{};
+    std::size_t rows{};
+    std::size_t columns{};
+    std::vector<Point<2>> ends{};
+    std::vector<uint8_t> converged{};
+    std::vector<uint32_t> iterations{};
+  };
+
+  /** State shared with the workers. Outlives the map if tiles are still
+   * running when it is destroyed. */
+  struct Shared {
+    std::atomic<bool> cancelled{false};
+    std::mutex mutex{};
+    /** Finished tiles not yet collected by `Poll()`. */
+    std::vector<Tile> finished{};
+  };
+
+  HeatmapGrid grid_;
+  std::size_t max_iterations_;
+  std::shared_ptr<Shared> shared;
+
+  std::vector<int32_t> labels_;
+  std::vector<uint32_t> iterations_;
+  std::vector<double> evaluations_;
+  uint32_t max_iterations_used_{0};
+  std::size_t limit_hits_{0};
+  std::size_t cells_done_{0};
+  std::vector<Point<2>> optima_{};
+  std::size_t tiles_done_{0};
+  std::size_t tiles_total_{0};
+
+  /** Index of the optimum at `end`, adding it if it is new. */
+  int32_t label(const Point<2> &end);
+};
+
+/** Finished and running basin maps, keyed by objective and options. */
+class BasinMapCache {
+public:
+  /** Keep at most `capacity` maps. The least recently used one is dropped
+   * first. */
+  explicit BasinMapCache(std::size_t capacity = 8) : capacity(capacity) {}
+
+  /**
+   * Map for the given objective and options. Starts computing it on `pool`
+   * if it is not cached. The reference is valid until the next call.
+   */
+  BasinMap &Get(ThreadPool &pool, const HeatmapGrid &grid,
+                FunctionPtr<2> funktion, double step_size,
+                std::size_t max_iterations);
+
+private:
+  struct Entry {
+    /** `function_fingerprint()` of the objective. */
+    uint64_t fingerprint{};
+    HeatmapGrid grid{};
+    double step_size{};
+    std::size_t max_iterations{};
+    std::unique_ptr<BasinMap> map{};
+    /** Value of `clock` at the last access. */
+    uint64_t used{};
+  };
+
+  std::size_t capacity;
+  std::vector<Entry> entries{};
+  uint64_t clock{0};
+};
+
+#endif // BASIN_MAP_H_
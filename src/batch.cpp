@@ -0,0 +1,114 @@
+/**
+ * @file batch.cpp
+ *
+ * @brief Implementation of the buffered start point reader.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "batch.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+StartPointReader::StartPointReader(const std::string &path)
+    : fd(path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY)),
+      owned(path != "-") {
+  if (fd < 0) {
+    throw std::runtime_error("Could not open '" + path +
+                             "': " + std::strerror(errno));
+  }
+}
+
+StartPointReader::~StartPointReader() {
+  if (owned) {
+    ::close(fd);
+  }
+}
+
+bool StartPointReader::fill() {
+  if (eof) {
+    return false;
+  }
+  if (begin > 0) {
+    std::memmove(buffer.get(), buffer.get() + begin, end - begin);
+    end -= begin;
+    begin = 0;
+  }
+  while (end < BUFFER_SIZE) {
+    const ssize_t n = ::read(fd, buffer.get() + end, BUFFER_SIZE - end);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      throw std::runtime_error(std::string("Could not read start points: ") +
+                               std::strerror(errno));
+    }
+    if (n == 0) {
+      eof = true;
+      break;
+    }
+    end += static_cast<std::size_t>(n);
+    return true;
+  }
+  return false;
+}
+
+bool StartPointReader::Next(std::vector<double> &coordinates) {
+  while (true) {
+    /* Find a complete line, reading more if necessary. The last line may
+     * lack its newline. */
+    const char *first = buffer.get() + begin;
+    const char *newline =
+        static_cast<const char *>(std::memchr(first, '\n', end - begin));
+    if (newline == nullptr) {
+      if (fill()) {
+        continue;
+      }
+      if (begin == end) {
+        return false;
+      }
+      if (end - begin == BUFFER_SIZE) {
+        throw std::runtime_error("Line " + std::to_string(line_ + 1) +
+                                 " is too long");
+      }
+      first = buffer.get() + begin;
+      newline = buffer.get() + end;
+    }
+    line_++;
+    const char *last = newline;
+    begin = std::min(end, static_cast<std::size_t>(newline - buffer.get()) + 1);
+
+    coordinates.clear();
+    const char *p = first;
+    while (true) {
+      while (p < last && (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')) {
+        p++;
+      }
+      if (p == last || *p == '#') {
+        break;
+      }
+      double value{};
+      const auto [number_end, error] = std::from_chars(p, last, value);
+      if (error != std::errc()) {
+        throw std::runtime_error("Invalid number in line " +
+                                 std::to_string(line_));
+      }
+      if (!std::isfinite(value)) {
+        throw std::runtime_error("Non-finite coordinate in line " +
+                                 std::to_string(line_));
+      }
+      coordinates.push_back(value);
+      p = number_end;
+    }
+    if (!coordinates.empty()) {
+      return true;
+    }
+  }
+}
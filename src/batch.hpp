@@ -0,0 +1,257 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+/**
+ * @file batch.hpp
+ *
+ * @brief Streaming batch optimization of many start points.
+ *
+ * Start points are read one line at a time from a file or standard input
+ * through a fixed-size buffer and parsed with `std::from_chars`. Each point
+ * becomes a task on a `ThreadPool`. At most `max_in_flight` of them are
+ * outstanding at any time: reading waits until the oldest result has been
+ * written. Results are written in input order through a ring of
+ * `max_in_flight` slots that reorders whatever finishes out of order.
+ * Memory use is therefore independent of the input size.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include "iteration.hpp"
+#include "thread_pool.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Buffered reader of start points. One point per line, coordinates
+ * separated by commas or blanks. A '#' starts a comment up to the end of
+ * the line, lines without coordinates are skipped. Coordinates must be
+ * finite.
+ */
+class StartPointReader {
+public:
+  /** Read buffer size. Also the maximum line length. */
+  static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+  /** Read from `path`, or from standard input if it is "-". Throws
+   * `std::runtime_error` if the file cannot be opened. */
+  explicit StartPointReader(const std::string &path);
+
+  /** Closes the file unless it is standard input. */
+  ~StartPointReader();
+
+  StartPointReader(const StartPointReader &) = delete;
+  StartPointReader &operator=(const StartPointReader &) = delete;
+
+  /**
+   * Parse the next point into `coordinates`, reusing its capacity. Throws
+   * `std::runtime_error` with the line number on malformed input.
+   *
+   * @returns 'false' at the end of the input.
+   */
+  bool Next(std::vector<double> &coordinates);
+
+  /** Number of the line read last, starting at one. */
+  [[nodiscard]] std::size_t line() const { return line_; }
+
+private:
+  int fd;
+  bool owned;
+  std::unique_ptr<char[]> buffer{new char[BUFFER_SIZE]};
+  /** Unparsed bytes are `buffer[begin, end)`. */
+  std::size_t begin{0};
+  std::size_t end{0};
+  bool eof{false};
+  std::size_t line_{0};
+
+  /** Move unparsed bytes to the front and read more. Returns 'false' if
+   * nothing was added. */
+  bool fill();
+};
+
+/** Outcome of one optimization run. */
+template <std::size_t N> struct RunResult {
+  CMyVektor<N> start{};
+  Point<N> end{};
+  double gradient_norm{};
+  std::size_t iterations{};
+  /** Objective evaluations of the whole run. Only set by callers that count
+   * them, e.g. the macro benchmark, zero otherwise. */
+  std::size_t evaluations{};
+  bool converged{};
+};
+
+/** Run gradient descent from `start` until it is done. */
+template <std::size_t N>
+[[nodiscard]] RunResult<N> Optimize(const CMyVektor<N> &start,
+                                    FunctionPtr<N> funktion, double step_size,
+                                    std::size_t max_iterations);
+
+/** An optimizer with the signature of `Optimize`. */
+template <std::size_t N>
+using OptimizerPtr = RunResult<N> (*)(const CMyVektor<N> &, FunctionPtr<N>,
+                                      double, std::size_t);
+
+/** Optimizers selectable by name, e.g. on the command line. */
+template <std::size_t N> struct NamedOptimizer {
+  const char *name;
+  OptimizerPtr<N> optimize;
+};
+
+template <std::size_t N>
+constexpr NamedOptimizer<N> OPTIMIZERS[] = {
+    {"gradient-descent", Optimize<N>},
+};
+
+/**
+ * Optimize from every point `next` yields and pass the results to `write`
+ * in the order of the points.
+ *
+ * @param pool Workers running the optimizations.
+ * @param max_in_flight Maximum number of points read but not yet written.
+ * @param next Callable `bool(CMyVektor<N> &)` that stores the next point
+ * and returns 'false' at the end. Called on this thread only.
+ * @param optimize Optimizer run from every point.
+ * @param write Callable `void(const RunResult<N> &)`. Called on this thread
+ * only.
+ *
+ * An exception thrown by `next`, `write` or an optimization, e.g. by an
+ * external objective, is rethrown on this thread once the tasks already
+ * running have finished. Tasks that have not started yet are skipped.
+ */
+template <std::size_t N, typename Source, typename Sink>
+void RunBatch(ThreadPool &pool, std::size_t max_in_flight, Source &&next,
+              OptimizerPtr<N> optimize, FunctionPtr<N> funktion,
+              double step_size, std::size_t max_iterations, Sink &&write);
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+template <std::size_t N>
+RunResult<N> Optimize(const CMyVektor<N> &start, FunctionPtr<N> funktion,
+                      double step_size, std::size_t max_iterations) {
+  auto iteration = IterationData<N>::AtPoint(start, funktion, step_size, 0);
+  while (!iteration.done(max_iterations)) {
+    ALLOC_FREE_SCOPE("Optimize step");
+    iteration = IterationData<N>::Next(iteration);
+  }
+  RunResult<N> result{};
+  result.start = start;
+  result.end = iteration.current;
+  result.gradient_norm = iteration.current_grad.norm();
+  result.iterations = iteration.index;
+  result.converged = result.gradient_norm < IterationData<N>::GRAD_LIMIT;
+  return result;
+}
+
+template <std::size_t N, typename Source, typename Sink>
+void RunBatch(ThreadPool &pool, std::size_t max_in_flight, Source &&next,
+              OptimizerPtr<N> optimize, FunctionPtr<N> funktion,
+              double step_size, std::size_t max_iterations, Sink &&write) {
+  if (max_in_flight == 0) {
+    max_in_flight = 1;
+  }
+
+  /* Point k goes to slot k % max_in_flight. Point k is only read once point
+   * k - max_in_flight has been written, so slots are never shared. The ring
+   * lives on the heap and outlives this function until the last task is
+   * done, which the wait at the end guarantees anyway. */
+  struct Slot {
+    RunResult<N> result{};
+    /** Set instead of `result` if the optimization threw. */
+    std::exception_ptr error{};
+    bool ready{false};
+  };
+  struct Ring {
+    std::mutex mutex{};
+    std::condition_variable done{};
+    std::vector<Slot> slots;
+    /** Tasks finished, successfully or not. */
+    std::size_t finished{0};
+    /** Set on the first error, tells queued tasks not to start. */
+    bool failed{false};
+    explicit Ring(std::size_t size) : slots(size) {}
+  };
+  const auto ring = std::make_shared<Ring>(max_in_flight);
+
+  std::size_t read = 0;
+  std::size_t written = 0;
+  const auto write_ready = [&](std::unique_lock<std::mutex> &lock) {
+    while (written < read && ring->slots[written % max_in_flight].ready) {
+      Slot &slot = ring->slots[written % max_in_flight];
+      slot.ready = false;
+      if (slot.error) {
+        ring->failed = true;
+        std::rethrow_exception(std::exchange(slot.error, nullptr));
+      }
+      const RunResult<N> result = slot.result;
+      /* Workers may finish other slots while writing. */
+      lock.unlock();
+      write(result);
+      lock.lock();
+      written++;
+    }
+  };
+
+  try {
+    CMyVektor<N> start{};
+    while (next(start)) {
+      {
+        /* Backpressure: wait for the oldest point before reading more. */
+        std::unique_lock lock(ring->mutex);
+        write_ready(lock);
+        while (read - written == max_in_flight) {
+          ring->done.wait(lock);
+          write_ready(lock);
+        }
+      }
+      const std::size_t slot = read % max_in_flight;
+      read++;
+      pool.Submit([ring, slot, start, optimize, funktion, step_size,
+                   max_iterations] {
+        RunResult<N> result{};
+        std::exception_ptr error{};
+        bool skipped = false;
+        {
+          const std::lock_guard lock(ring->mutex);
+          skipped = ring->failed;
+        }
+        if (!skipped) {
+          try {
+            result = optimize(start, funktion, step_size, max_iterations);
+          } catch (...) {
+            error = std::current_exception();
+          }
+        }
+        {
+          const std::lock_guard lock(ring->mutex);
+          ring->slots[slot].result = result;
+          ring->slots[slot].error = error;
+          ring->slots[slot].ready = true;
+          ring->finished++;
+        }
+        ring->done.notify_one();
+      });
+    }
+
+    std::unique_lock lock(ring->mutex);
+    write_ready(lock);
+    while (written < read) {
+      ring->done.wait(lock);
+      write_ready(lock);
+    }
+  } catch (...) {
+    /* Running tasks still call `funktion`, which may refer to objects of
+     * the caller, so they must be done before the error leaves. */
+    std::unique_lock lock(ring->mutex);
+    ring->failed = true;
+    ring->done.wait(lock, [&] { return ring->finished == read; });
+    throw;
+  }
+}
+
+#endif // BATCH_H_
@@ -0,0 +1,157 @@
+/**
+ * @file bench.cpp
+ *
+ * @brief Microbenchmarks of the numerical kernels.
+ *
+ * Usage: `plottings-bench [--filter <text>] [--min-time <seconds>]
+ * [--json <file>]`. Prints a table and optionally writes the results as
+ * JSON to compare them between builds.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "benchmark.hpp"
+#include "functions.hpp"
+#include "heatmap.hpp"
+#include "iteration.hpp"
+
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+constexpr FunctionPtr<2> F = counted<2, functions::f>;
+constexpr FunctionPtr<3> G = counted<3, functions::g>;
+
+/** Same as in the exercise tasks. */
+constexpr CMyVektor<2> START_F{0.2, -2.1};
+constexpr CMyVektor<3> START_G{0.0, 0.0, 0.0};
+constexpr double STEP_SIZE_G = 0.1;
+
+/** Heatmap size of the UI. */
+constexpr std::size_t HEATMAP_RESOLUTION = 64;
+
+void run_all(BenchmarkRunner &runner) {
+  CMyVektor<2> a{0.3, -1.2};
+  CMyVektor<2> b{2.5, 0.7};
+  CMyVektor<3> c{0.3, -1.2, 2.0};
+
+  runner.Run("CMyVektor<2>::norm", [&] {
+    do_not_optimize(a);
+    do_not_optimize(a.norm());
+  });
+  runner.Run("CMyVektor<3>::norm", [&] {
+    do_not_optimize(c);
+    do_not_optimize(c.norm());
+  });
+  runner.Run("CMyVektor<2>::operator+", [&] {
+    do_not_optimize(a);
+    do_not_optimize(a + b);
+  });
+  runner.Run("CMyVektor<2>::operator*", [&] {
+    do_not_optimize(a);
+    do_not_optimize(2.5 * a);
+  });
+  runner.Run("CMyVektor<2>::gradient(f)", [&] {
+    do_not_optimize(a);
+    do_not_optimize(a.gradient(F));
+  });
+  runner.Run("CMyVektor<3>::gradient(g)", [&] {
+    do_not_optimize(c);
+    do_not_optimize(c.gradient(G));
+  });
+
+  runner.Run("IterationData<2>::AtPoint(f)", [&] {
+    do_not_optimize(a);
+    do_not_optimize(IterationData<2>::AtPoint(a, F, 1.0, 0));
+  });
+  const auto first = IterationData<2>::AtPoint(START_F, F, 1.0, 0);
+  runner.Run("IterationData<2>::Next(f)", [&] {
+    do_not_optimize(first);
+    do_not_optimize(IterationData<2>::Next(first));
+  });
+
+  const auto quiet = [](const auto &) {};
+  runner.Run("gradient_descent(f)", [&] {
+    do_not_optimize(gradient_descent<2>(START_F, F, 1.0, quiet));
+  });
+  runner.Run("gradient_descent(g)", [&] {
+    do_not_optimize(gradient_descent<3>(START_G, G, STEP_SIZE_G, quiet));
+  });
+
+  for (const auto precision : {HeatmapPrecision::Float64,
+                               HeatmapPrecision::Float32,
+                               HeatmapPrecision::UNorm16}) {
+    Heatmap heatmap(HEATMAP_RESOLUTION, -2.0, -2.0, 4.0, precision);
+    static constexpr const char *NAMES[] = {"f64", "f32", "u16"};
+    runner.Run("Heatmap::Fill(f, " +
+                   std::string(NAMES[static_cast<int>(precision)]) + ")",
+               [&] {
+                 heatmap.Fill(F);
+                 do_not_optimize(heatmap.max());
+               });
+  }
+}
+
+struct Options {
+  std::string filter{};
+  double min_time{BenchmarkRunner::DEFAULT_MIN_TIME};
+  std::string json_path{};
+};
+
+Options parse_options(int argc, char **argv) {
+  Options options{};
+  for (int i = 1; i < argc; i += 2) {
+    const std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      throw std::invalid_argument("Missing value for '" + std::string(arg) +
+                                  "'");
+    }
+    const std::string value = argv[i + 1];
+    if (arg == "--filter") {
+      options.filter = value;
+    } else if (arg == "--min-time") {
+      try {
+        options.min_time = std::stod(value);
+      } catch (const std::logic_error &) {
+        throw std::invalid_argument("Invalid value '" + value + "' for '" +
+                                    std::string(arg) + "'");
+      }
+      if (!(options.min_time > 0.0)) {
+        throw std::invalid_argument("The minimum time must be positive");
+      }
+    } else if (arg == "--json") {
+      options.json_path = value;
+    } else {
+      throw std::invalid_argument("Unknown argument '" + std::string(arg) +
+                                  "'");
+    }
+  }
+  return options;
+}
+} // namespace
+
+auto main(int argc, char **argv) -> int {
+  Options options{};
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  try {
+    BenchmarkRunner runner(options.filter, options.min_time);
+    run_all(runner);
+    runner.Print();
+    if (!options.json_path.empty()) {
+      runner.WriteJson(options.json_path);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
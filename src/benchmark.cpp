@@ -0,0 +1,90 @@
+/**
+ * @file benchmark.cpp
+ *
+ * @brief Reporting of the benchmark harness.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "benchmark.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+/** `value` right-aligned in `width` columns, "-" if it is NaN. */
+void print_metric(double value, int width, int precision) {
+  if (std::isnan(value)) {
+    std::printf(" %*s", width, "-");
+  } else {
+    std::printf(" %*.*f", width, precision, value);
+  }
+}
+
+/** `value` as JSON number, null if it is not finite. */
+void write_json_number(std::FILE *file, const char *key, double value) {
+  if (std::isfinite(value)) {
+    std::fprintf(file, ", \"%s\": %.17g", key, value);
+  } else {
+    std::fprintf(file, ", \"%s\": null", key);
+  }
+}
+} // namespace
+
+void BenchmarkRunner::Print() const {
+  std::printf("%-32s %14s %12s %16s %12s %8s %16s %16s\n", "benchmark",
+              "ns/op", "evals/op", "evals/s", "allocs/op", "IPC",
+              "cache-miss/eval", "branch-miss/eval");
+  for (const auto &result : results_) {
+    std::printf("%-32s %14.2f %12.2f %16.4g %12.2f", result.name.c_str(),
+                result.ns_per_op, result.evaluations_per_op,
+                result.evaluations_per_second, result.allocations_per_op);
+    print_metric(result.ipc(), 8, 2);
+    print_metric(result.per_evaluation(result.cache_misses_per_op), 16, 4);
+    print_metric(result.per_evaluation(result.branch_misses_per_op), 16, 4);
+    std::printf("\n");
+  }
+  if (!counters_.error().empty()) {
+    std::printf("Missing hardware counters: %s\n", counters_.error().c_str());
+  }
+}
+
+void BenchmarkRunner::WriteJson(const std::string &path) const {
+  const std::unique_ptr<std::FILE, decltype(&std::fclose)> file(
+      std::fopen(path.c_str(), "w"), &std::fclose);
+  if (!file) {
+    throw std::runtime_error("Could not open '" + path + "' for writing");
+  }
+  std::fprintf(file.get(), "{\n  \"benchmarks\": [");
+  for (std::size_t i = 0; i < results_.size(); i++) {
+    const BenchmarkResult &result = results_[i];
+    std::fprintf(file.get(),
+                 "%s\n    {\"name\": \"%s\", \"ops\": %llu, \"ns_per_op\": "
+                 "%.17g, \"evaluations_per_op\": %.17g, "
+                 "\"evaluations_per_second\": %.17g, "
+                 "\"allocations_per_op\": %.17g",
+                 i == 0 ? "" : ",", result.name.c_str(),
+                 static_cast<unsigned long long>(result.ops), result.ns_per_op,
+                 result.evaluations_per_op, result.evaluations_per_second,
+                 result.allocations_per_op);
+    write_json_number(file.get(), "cycles_per_op", result.cycles_per_op);
+    write_json_number(file.get(), "instructions_per_op",
+                      result.instructions_per_op);
+    write_json_number(file.get(), "cache_misses_per_op",
+                      result.cache_misses_per_op);
+    write_json_number(file.get(), "branch_misses_per_op",
+                      result.branch_misses_per_op);
+    write_json_number(file.get(), "ipc", result.ipc());
+    write_json_number(file.get(), "cache_misses_per_evaluation",
+                      result.per_evaluation(result.cache_misses_per_op));
+    write_json_number(file.get(), "branch_misses_per_evaluation",
+                      result.per_evaluation(result.branch_misses_per_op));
+    std::fprintf(file.get(), "}");
+  }
+  std::fprintf(file.get(), "\n  ]\n}\n");
+  if (std::ferror(file.get()) != 0) {
+    throw std::runtime_error("Could not write '" + path + "'");
+  }
+}
@@ -0,0 +1,185 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+/**
+ * @file benchmark.hpp
+ *
+ * @brief Minimal microbenchmark harness.
+ *
+ * `BenchmarkRunner::Run` calls an operation in a loop until the loop takes
+ * long enough to time reliably, then times `SAMPLES` such loops and reports
+ * the median time per operation. Objective evaluations are counted by
+ * wrapping the objective in `counted<N, F>`, allocations by the counting
+ * `operator new` of alloc_counter.cpp. Cycles, instructions, cache and
+ * branch misses come from `PerfCounters` where the kernel allows it.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "alloc_counter.hpp"
+#include "cmyvektor.hpp"
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Measurements of one benchmark. */
+struct BenchmarkResult {
+  std::string name{};
+  /** Operations per timed sample. */
+  uint64_t ops{};
+  /** Median over the samples. */
+  double ns_per_op{};
+  double evaluations_per_op{};
+  /** Objective evaluations per second of run time. Zero if the operation
+   * does not evaluate the objective. */
+  double evaluations_per_second{};
+  double allocations_per_op{};
+  /** Hardware counters per operation, over all samples. NaN if the counter
+   * is not available. */
+  double cycles_per_op{NAN};
+  double instructions_per_op{NAN};
+  double cache_misses_per_op{NAN};
+  double branch_misses_per_op{NAN};
+
+  /** Instructions per cycle. */
+  [[nodiscard]] double ipc() const {
+    return instructions_per_op / cycles_per_op;
+  }
+  /** `per_op` per objective evaluation, NaN without evaluations. */
+  [[nodiscard]] double per_evaluation(double per_op) const {
+    return evaluations_per_op > 0.0 ? per_op / evaluations_per_op : NAN;
+  }
+};
+
+/** Objective evaluations by `counted` functions. Benchmarks run on one
+ * thread, so this is a plain counter. */
+inline uint64_t benchmark_evaluations = 0;
+
+/** `F` that counts its calls in `benchmark_evaluations`. */
+template <std::size_t N, FunctionPtr<N> F>
+double counted(const CMyVektor<N> &x) {
+  benchmark_evaluations++;
+  return F(x);
+}
+
+/** Keep the compiler from optimizing `value` and its computation away. */
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** Runs benchmarks and collects their results. */
+class BenchmarkRunner {
+public:
+  /** Number of timed loops per benchmark. */
+  static constexpr int SAMPLES = 5;
+
+  /** Default minimum run time per timed loop in seconds. */
+  static constexpr double DEFAULT_MIN_TIME = 0.05;
+
+  /**
+   * @param filter Only benchmarks whose name contains it are run.
+   * @param min_time Minimum run time per timed loop in seconds.
+   */
+  explicit BenchmarkRunner(std::string filter = "",
+                           double min_time = DEFAULT_MIN_TIME)
+      : filter(std::move(filter)), min_time(min_time) {}
+
+  /** Time `op`, a callable without arguments, unless it is filtered out. */
+  template <typename Op> void Run(const std::string &name, Op &&op);
+
+  [[nodiscard]] const std::vector<BenchmarkResult> &results() const {
+    return results_;
+  }
+
+  /** Whether hardware counters are measured, see `PerfCounters`. */
+  [[nodiscard]] const PerfCounters &counters() const { return counters_; }
+
+  /** Print a table of the results to standard output. */
+  void Print() const;
+
+  /** Write the results as JSON object to `path`. Throws
+   * `std::runtime_error` on failure. */
+  void WriteJson(const std::string &path) const;
+
+private:
+  std::string filter;
+  double min_time;
+  std::vector<BenchmarkResult> results_{};
+  PerfCounters counters_{};
+};
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+template <typename Op>
+void BenchmarkRunner::Run(const std::string &name, Op &&op) {
+  using Clock = std::chrono::steady_clock;
+  if (name.find(filter) == std::string::npos) {
+    return;
+  }
+
+  const auto time_loop = [&](uint64_t ops) {
+    const auto start = Clock::now();
+    for (uint64_t i = 0; i < ops; i++) {
+      op();
+    }
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  };
+
+  /* Grow the loop until it runs for a tenth of the minimum time, then
+   * extrapolate. */
+  uint64_t ops = 1;
+  while (true) {
+    const double elapsed = time_loop(ops);
+    if (elapsed >= min_time / 10.0 || ops >= (uint64_t{1} << 40)) {
+      ops = std::max<uint64_t>(
+          1, static_cast<uint64_t>(static_cast<double>(ops) * min_time /
+                                   std::max(elapsed, 1e-9)));
+      break;
+    }
+    ops *= 10;
+  }
+
+  std::vector<double> seconds;
+  seconds.reserve(SAMPLES);
+  const uint64_t evaluations = benchmark_evaluations;
+  const uint64_t allocations = allocation_count();
+  counters_.Start();
+  for (int sample = 0; sample < SAMPLES; sample++) {
+    seconds.push_back(time_loop(ops));
+  }
+  const PerfSample counts = counters_.Stop();
+  const double total_ops = static_cast<double>(ops) * SAMPLES;
+  const double evaluations_per_op =
+      static_cast<double>(benchmark_evaluations - evaluations) / total_ops;
+  /* The sample vector has its capacity before the first sample, so the
+   * harness itself does not show up here. */
+  const double allocations_per_op =
+      static_cast<double>(allocation_count() - allocations) / total_ops;
+
+  std::sort(seconds.begin(), seconds.end());
+  const double ns_per_op =
+      seconds[SAMPLES / 2] * 1e9 / static_cast<double>(ops);
+
+  BenchmarkResult result{};
+  result.name = name;
+  result.ops = ops;
+  result.ns_per_op = ns_per_op;
+  result.evaluations_per_op = evaluations_per_op;
+  result.evaluations_per_second =
+      ns_per_op > 0.0 ? evaluations_per_op * 1e9 / ns_per_op : 0.0;
+  result.allocations_per_op = allocations_per_op;
+  const auto per_op = [&](PerfEvent event) {
+    const auto count = counts[event];
+    return count ? *count / total_ops : NAN;
+  };
+  result.cycles_per_op = per_op(PerfEvent::Cycles);
+  result.instructions_per_op = per_op(PerfEvent::Instructions);
+  result.cache_misses_per_op = per_op(PerfEvent::CacheMisses);
+  result.branch_misses_per_op = per_op(PerfEvent::BranchMisses);
+  results_.push_back(result);
+}
+
+#endif // BENCHMARK_H_
@@ -0,0 +1,185 @@
+/**
+ * @file c_api.cpp
+ *
+ * @brief Implementation of the C interface on top of `Optimize`.
+ *
+ * The optimizer takes plain function pointers, so the callback and its user
+ * data reach it through a thread-local context that a trampoline per
+ * dimension reads. Each run installs its own context and restores the
+ * previous one afterwards, which keeps concurrent runs on other threads and
+ * nested runs from objectives apart.
+ *
+ * Batched objectives are evaluated a gradient stencil at a time through a
+ * `StencilCache`, so every iteration takes two calls.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "plottings.h"
+#include "batch.hpp"
+#include "stencil_cache.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+namespace {
+/** Callback of the scalar run on this thread. */
+struct ScalarContext {
+  plottings_objective objective;
+  void *user_data;
+  std::size_t evaluations{0};
+};
+
+thread_local ScalarContext *scalar_context = nullptr;
+
+template <std::size_t N> double scalar_trampoline(const CMyVektor<N> &x) {
+  ScalarContext &context = *scalar_context;
+  context.evaluations++;
+  return context.objective(x.data(), N, context.user_data);
+}
+
+/** Callback of the batched run on this thread and its last stencils. */
+template <std::size_t N> struct BatchContext {
+  plottings_batch_objective objective;
+  void *user_data;
+  std::size_t evaluations{0};
+  std::size_t calls{0};
+  StencilCache<N> cache{};
+};
+
+template <std::size_t N>
+thread_local BatchContext<N> *batch_context = nullptr;
+
+template <std::size_t N> double batch_trampoline(const CMyVektor<N> &x) {
+  BatchContext<N> &context = *batch_context<N>;
+  return context.cache.Get(x, [&](const double *points, double *values) {
+    context.objective(points, StencilCache<N>::POINTS, N, values,
+                      context.user_data);
+    context.evaluations += StencilCache<N>::POINTS;
+    context.calls++;
+  });
+}
+
+template <std::size_t N>
+void fill_result(const RunResult<N> &run, plottings_result &result) {
+  result = plottings_result{};
+  for (std::size_t i = 0; i < N; i++) {
+    result.x[i] = run.end.vector[i];
+  }
+  result.value = run.end.value;
+  result.gradient_norm = run.gradient_norm;
+  result.iterations = run.iterations;
+  result.converged = run.converged ? 1 : 0;
+}
+
+template <std::size_t N> CMyVektor<N> to_vector(const double *start) {
+  CMyVektor<N> x{};
+  for (std::size_t i = 0; i < N; i++) {
+    x[i] = start[i];
+  }
+  return x;
+}
+
+template <std::size_t N>
+void run_scalar(const double *start, const plottings_options &options,
+                plottings_objective objective, void *user_data,
+                plottings_result &result) {
+  ScalarContext context{objective, user_data};
+  ScalarContext *const previous = std::exchange(scalar_context, &context);
+  const RunResult<N> run =
+      Optimize<N>(to_vector<N>(start), scalar_trampoline<N>,
+                  options.step_size, options.max_iterations);
+  scalar_context = previous;
+
+  fill_result(run, result);
+  result.evaluations = context.evaluations;
+  result.callback_calls = context.evaluations;
+}
+
+template <std::size_t N>
+void run_batched(const double *start, const plottings_options &options,
+                 plottings_batch_objective objective, void *user_data,
+                 plottings_result &result) {
+  BatchContext<N> context{objective, user_data};
+  BatchContext<N> *const previous = std::exchange(batch_context<N>, &context);
+  const RunResult<N> run =
+      Optimize<N>(to_vector<N>(start), batch_trampoline<N>, options.step_size,
+                  options.max_iterations);
+  batch_context<N> = previous;
+
+  fill_result(run, result);
+  result.evaluations = context.evaluations;
+  result.callback_calls = context.calls;
+}
+
+/** Call `run.template operator()<N>()` with N = `dimension`. */
+template <typename Run, std::size_t... Ns>
+void dispatch(std::size_t dimension, Run &&run, std::index_sequence<Ns...>) {
+  static_cast<void>(((dimension == Ns + 1
+                          ? (run.template operator()<Ns + 1>(), true)
+                          : false) ||
+                     ...));
+}
+
+bool valid(const double *start, const plottings_options *options,
+           bool has_objective, const plottings_result *result) {
+  return start != nullptr && options != nullptr && has_objective &&
+         result != nullptr && options->dimension >= 1 &&
+         options->dimension <= PLOTTINGS_MAX_DIMENSION &&
+         std::isfinite(options->step_size) && options->step_size > 0.0;
+}
+} // namespace
+
+extern "C" {
+plottings_options plottings_default_options(size_t dimension) {
+  plottings_options options{};
+  options.dimension = dimension;
+  options.step_size = 1.0;
+  options.max_iterations = IterationData<1>::MAX_ITERATIONS;
+  return options;
+}
+
+plottings_status plottings_gradient_descent(const double *start,
+                                            const plottings_options *options,
+                                            plottings_objective objective,
+                                            void *user_data,
+                                            plottings_result *result) {
+  if (!valid(start, options, objective != nullptr, result)) {
+    return PLOTTINGS_INVALID_ARGUMENT;
+  }
+  dispatch(
+      options->dimension,
+      [&]<std::size_t N>() {
+        run_scalar<N>(start, *options, objective, user_data, *result);
+      },
+      std::make_index_sequence<PLOTTINGS_MAX_DIMENSION>{});
+  return PLOTTINGS_OK;
+}
+
+plottings_status plottings_gradient_descent_batched(
+    const double *start, const plottings_options *options,
+    plottings_batch_objective objective, void *user_data,
+    plottings_result *result) {
+  if (!valid(start, options, objective != nullptr, result)) {
+    return PLOTTINGS_INVALID_ARGUMENT;
+  }
+  dispatch(
+      options->dimension,
+      [&]<std::size_t N>() {
+        run_batched<N>(start, *options, objective, user_data, *result);
+      },
+      std::make_index_sequence<PLOTTINGS_MAX_DIMENSION>{});
+  return PLOTTINGS_OK;
+}
+
+const char *plottings_status_string(plottings_status status) {
+  switch (status) {
+  case PLOTTINGS_OK:
+    return "ok";
+  case PLOTTINGS_INVALID_ARGUMENT:
+    return "invalid argument";
+  }
+  return "unknown status";
+}
+}
@@ -0,0 +1,148 @@
+/**
+ * @file calc_model.cpp
+ *
+ * @brief Implementation of the visualization state machine.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "calc_model.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+void CalcModel::Apply(const InputEvent &event) {
+  switch (event.kind) {
+  case InputKind::StartX:
+  case InputKind::StartY:
+  case InputKind::MaxIterations:
+    if (state_ != CalcState::Init) {
+      return;
+    }
+    if (event.kind == InputKind::StartX) {
+      start_[0] = event.value;
+    } else if (event.kind == InputKind::StartY) {
+      start_[1] = event.value;
+    } else {
+      max_iterations_ = std::max<std::size_t>(
+          1, static_cast<std::size_t>(std::max(event.value, 0.0)));
+    }
+    iteration_data_init =
+        IterationData<2>::AtPoint(start_, functions::f, INIT_STEP_SIZE_F, 0);
+    return;
+  case InputKind::StartCalculation:
+    if (state_ != CalcState::Init) {
+      return;
+    }
+    if (remote) {
+      remote->Start(start_, INIT_STEP_SIZE_F, max_iterations_);
+    } else if (precomputed && precomputed_start == start_ &&
+               precomputed_max_iterations == max_iterations_) {
+      trajectory = std::move(*precomputed);
+    } else {
+      trajectory = Trajectory<2>::Record(iteration_data_init, max_iterations_);
+    }
+    precomputed.reset();
+    iteration_ = 0;
+    break;
+  case InputKind::Iteration:
+    if (state_ == CalcState::Init) {
+      return;
+    }
+    iteration_ = std::min(last_iteration(),
+                          static_cast<std::size_t>(std::max(event.value, 0.0)));
+    break;
+  case InputKind::Reset:
+    if (state_ != CalcState::Done && !failed()) {
+      return;
+    }
+    state_ = CalcState::Init;
+    iteration_ = 0;
+    return;
+  }
+  update_state();
+}
+
+void CalcModel::update_state() {
+  /* The calculation is done when the slider reaches the end of the run. */
+  state_ = complete() && iteration_ >= last_iteration()
+               ? CalcState::Done
+               : CalcState::MidCalculation;
+}
+
+void CalcModel::Precomputed(const CMyVektor<2> &start,
+                            std::size_t max_iterations,
+                            Trajectory<2> trajectory) {
+  precomputed = std::move(trajectory);
+  precomputed_start = start;
+  precomputed_max_iterations = max_iterations;
+}
+
+void CalcModel::Connect(const std::string &endpoint) {
+  remote = std::make_unique<RemoteRun>(endpoint);
+}
+
+void CalcModel::Attach(uint32_t run_id) {
+  remote->Attach(run_id);
+  iteration_ = 0;
+  update_state();
+}
+
+void CalcModel::Refresh() {
+  /* A run that finishes while the slider rests on its last iteration is
+   * done without any input. */
+  if (remote && state_ != CalcState::Init) {
+    update_state();
+  }
+}
+
+std::size_t CalcModel::last_iteration() const {
+  if (remote) {
+    const std::size_t size = remote->size();
+    return size == 0 ? 0 : size - 1;
+  }
+  return trajectory.empty() ? 0 : trajectory.size() - 1;
+}
+
+const IterationData<2> &CalcModel::current() const {
+  if (state_ == CalcState::Init) {
+    return iteration_data_init;
+  }
+  if (remote) {
+    if (remote->size() == 0) {
+      return iteration_data_init;
+    }
+    remote_current = remote->At(iteration_);
+    return remote_current;
+  }
+  return trajectory.At(iteration_);
+}
+
+CMyVektor<2> CalcModel::PointAt(std::size_t iteration) const {
+  if (state_ == CalcState::Init) {
+    return iteration_data_init.current.vector;
+  }
+  iteration = std::min(iteration, last_iteration());
+  if (remote) {
+    if (remote->size() == 0) {
+      return iteration_data_init.current.vector;
+    }
+    return remote->At(iteration).current.vector;
+  }
+  return trajectory.At(iteration).current.vector;
+}
+
+const std::string &CalcModel::Describe() const {
+  const IterationData<2> &iteration = current();
+  /* The rest of an iteration follows from these for the same function. */
+  if (!described || described->index != iteration.index ||
+      described->step_size != iteration.step_size ||
+      described->current.vector != iteration.current.vector) {
+    std::stringstream ss;
+    ss << iteration;
+    description = ss.str();
+    described = iteration;
+  }
+  return description;
+}
@@ -0,0 +1,143 @@
+#ifndef CALC_MODEL_H_
+#define CALC_MODEL_H_
+/**
+ * @file calc_model.hpp
+ *
+ * @brief State of the gradient descent visualization without any drawing.
+ *
+ * `GuiHandle` draws the widgets and turns user input into `InputEvent`s that
+ * are applied here. The headless replay applies recorded events to the same
+ * model, so both paths compute exactly the same thing.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "functions.hpp"
+#include "input_log.hpp"
+#include "iteration.hpp"
+#include "remote_run.hpp"
+#include "trajectory.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+/** Finite state machine of the gradient descent visualization of f(x). */
+class CalcModel {
+public:
+  /**
+   * State of steepest-descent calculation.
+   */
+  enum class CalcState {
+    /** Init-state: Customization of initialization value possible. */
+    Init,
+    /** Calculating: Customization of initialization value not possible. */
+    MidCalculation,
+    /** Calculation is done. Show result until the user clicks on 'reset'. */
+    Done,
+  };
+
+  /** Apply one user input. Inputs not allowed in the current state are
+   * ignored. */
+  void Apply(const InputEvent &event);
+
+  /** Run calculations on the compute server at `endpoint` instead of
+   * locally. */
+  void Connect(const std::string &endpoint);
+
+  /** Show the run `run_id` of the compute server. Requires `Connect()`. */
+  void Attach(uint32_t run_id);
+
+  /** Follow a compute server run that received iterations or finished
+   * since the last call. Call once per frame. */
+  void Refresh();
+
+  /**
+   * Offer a run recorded elsewhere, e.g. speculatively in the background.
+   * "Start Calculation" uses it instead of recording again if start and
+   * iteration limit still match.
+   */
+  void Precomputed(const CMyVektor<2> &start, std::size_t max_iterations,
+                   Trajectory<2> trajectory);
+
+  /** Compute server run, `nullptr` if calculating locally. */
+  [[nodiscard]] const RemoteRun *remote_run() const { return remote.get(); }
+
+  /** Current state of finite state machine. */
+  [[nodiscard]] CalcState state() const { return state_; }
+
+  /** Start vector to start optimization from. */
+  [[nodiscard]] const CMyVektor<2> &start() const { return start_; }
+
+  /** Iteration limit of the recorded run. */
+  [[nodiscard]] std::size_t max_iterations() const { return max_iterations_; }
+
+  /** Iteration index to visualize. */
+  [[nodiscard]] std::size_t iteration() const { return iteration_; }
+
+  /** Last valid iteration index. Zero if nothing has been calculated. */
+  [[nodiscard]] std::size_t last_iteration() const;
+
+  /** Iteration to visualize. The first iteration in the Init state. */
+  [[nodiscard]] const IterationData<2> &current() const;
+
+  /** Whether the run has all of its iterations. Remote runs may still be
+   * streaming. A failed remote run gets no more and is complete as well. */
+  [[nodiscard]] bool complete() const {
+    return !remote || remote->finished() || remote->failed();
+  }
+
+  /** Whether the remote run ended with an error. It can then be reset
+   * before the slider reaches its end. */
+  [[nodiscard]] bool failed() const { return remote && remote->failed(); }
+
+  /**
+   * Point visited at `iteration`, clamped to the run. Invalidates the
+   * reference returned by `current()`.
+   */
+  [[nodiscard]] CMyVektor<2> PointAt(std::size_t iteration) const;
+
+  /** Human-readable description of `current()` for the text panel. Only
+   * formatted again when `current()` changed, so unchanged frames do not
+   * allocate. */
+  [[nodiscard]] const std::string &Describe() const;
+
+  static constexpr double INIT_STEP_SIZE_F = 1.0;
+
+private:
+  CalcState state_{CalcState::Init};
+
+  CMyVektor<2> start_{0.2, -2.1};
+
+  std::size_t max_iterations_{IterationData<2>::MAX_ITERATIONS};
+
+  std::size_t iteration_{0};
+
+  /** First gradient descent iteration with index zero. */
+  IterationData<2> iteration_data_init{
+      IterationData<2>::AtPoint(start_, functions::f, INIT_STEP_SIZE_F, 0)};
+
+  /** Run recorded when the calculation is started. The iteration slider seeks
+   * in this trajectory instead of replaying all steps each frame. */
+  Trajectory<2> trajectory{};
+
+  /** Run offered by `Precomputed()`, with its start and iteration limit. */
+  std::optional<Trajectory<2>> precomputed{};
+  CMyVektor<2> precomputed_start{};
+  std::size_t precomputed_max_iterations{0};
+
+  /** Compute server run. Replaces `trajectory` if set. */
+  std::unique_ptr<RemoteRun> remote{};
+
+  /** Copy of the remote iteration returned by `current()`. */
+  mutable IterationData<2> remote_current{};
+
+  /** Result of `Describe()` and the iteration it describes. */
+  mutable std::string description{};
+  mutable std::optional<IterationData<2>> described{};
+
+  /** Update the state after the iteration or the run changed. */
+  void update_state();
+};
+
+#endif // CALC_MODEL_H_
@@ -0,0 +1,19 @@
+/**
+ * @file cli.cpp
+ *
+ * @brief Command line optimizer without GUI dependencies.
+ *
+ * Runs the headless mode of headless.hpp, so `plottings-cli <args>` is the
+ * same as `plottings --headless <args>` but also exists in builds with
+ * `PLOTTINGS_BUILD_GUI=OFF`.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "headless.hpp"
+#include "trace.hpp"
+
+auto main(int argc, char **argv) -> int {
+  TRACE_THREAD_NAME("main");
+  return RunHeadless(argc - 1, argv + 1);
+}
@@ -12,6 +12,8 @@
  * @author Johannes Schiffer
  * @date 03-05-2024
  */
+#include "eval_profile.hpp"
+#include "trace.hpp"
 #include <array>
 #include <cmath>
 #include <iostream>
@@ -46,6 +48,11 @@ template <std::size_t N> using FunctionPtr = double (*)(const CMyVektor<N> &x);
  * @tparam N Dimension of the vector.
  */
 template <std::size_t N> struct CMyVektor : public std::array<double, N> {
+  /** h-value used in gradient calculation. `gradient` evaluates the
+   * function at this vector and at this vector with `H` added to one
+   * element. */
+  static constexpr double H = 10.0e-8;
+
   /** Task 2: Make gradient vector from input vector with function pointer. */
   [[nodiscard]] CMyVektor gradient(FunctionPtr<N> funktion) const;
 
@@ -56,20 +63,32 @@ template <std::size_t N> struct CMyVektor : public std::array<double, N> {
   using std::array<double, N>::operator[];
 };
 
+/** `funktion(x)`. The single place objective evaluations are traced and
+ * profiled, `site` tells the profile where the call comes from. */
+template <std::size_t N>
+inline double evaluate(FunctionPtr<N> funktion, const CMyVektor<N> &x,
+                       [[maybe_unused]] eval_profile::Site site =
+                           eval_profile::Site::Other) {
+  TRACE_DETAIL_SCOPE("evaluate");
+  EVAL_PROFILE_SCOPE(site);
+  return funktion(x);
+}
+
 /* NOTE: templated function must be implemented in header file instead of
  * source. */
 /* ------------ IMPLEMENTATION ----------------------------------------- */
 template <std::size_t N>
 CMyVektor<N> CMyVektor<N>::gradient(FunctionPtr<N> funktion) const {
-  /* h-value used in gradient calculation. */
-  static constexpr double H = 10.0e-8;
+  TRACE_DETAIL_SCOPE("CMyVektor::gradient");
   CMyVektor<N> ret;
   /* iterate target (gradient) elements */
   for (std::size_t i = 0; i < N; i++) {
     /* Need vector `x` with element at index i replaced by `x(i) + H`. */
     CMyVektor arg = *this;
     arg[i] += H;
-    ret[i] = (funktion(arg) - funktion(*this)) / H;
+    ret[i] = (evaluate(funktion, arg, eval_profile::Site::Gradient) -
+              evaluate(funktion, *this, eval_profile::Site::Gradient)) /
+             H;
   }
   return ret;
 };
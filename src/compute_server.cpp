@@ -0,0 +1,400 @@
+/**
+ * @file compute_server.cpp
+ *
+ * @brief Compute daemon that runs gradient descent jobs out of the UI
+ * process.
+ *
+ * Runs are executed in their own threads and keep all iterations in memory,
+ * so any number of clients can attach to a run while it is in progress or
+ * after it has finished. Finished runs nobody streams are dropped after
+ * `FINISHED_RUN_LIFETIME` or once more than `MAX_FINISHED_RUNS` of them
+ * pile up, later attaches get "Unknown run". A crashing objective takes
+ * down the server but not the viewers attached to it.
+ *
+ * `Optimize` jobs only need their final points and go to a `JobService`
+ * shared by all clients, which batches them on a persistent worker pool.
+ * Their answers are sent from the workers, so every connection serializes
+ * its writes.
+ *
+ * Usage: `plottings-server [endpoint]`, default `unix:/tmp/plottings.sock`.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "functions.hpp"
+#include "iteration.hpp"
+#include "job_service.hpp"
+#include "protocol.hpp"
+#include "socket.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/** One gradient descent run and its encoded iterations. */
+struct Run {
+  uint32_t id{};
+  std::size_t dim{};
+
+  /** Protects `data`, `size` and `finished`. */
+  std::mutex mutex{};
+  std::condition_variable changed{};
+  /** `size` records of `protocol::record_size(dim)` bytes each. */
+  std::vector<uint8_t> data{};
+  std::size_t size{0};
+  bool finished{false};
+  std::chrono::steady_clock::time_point finished_at{};
+
+  /** Clients streaming the run, protected by the server's `runs_mutex`. */
+  std::size_t readers{0};
+
+  std::thread worker{};
+};
+
+/** A client socket shared between its reader and the job workers. */
+struct Connection {
+  explicit Connection(Socket socket) : socket(std::move(socket)) {}
+
+  Socket socket;
+  /** Held for every message sent, so messages do not interleave. */
+  std::mutex write_mutex{};
+
+  void Send(protocol::Type type, const void *head, std::size_t head_size,
+            const void *tail = nullptr, std::size_t tail_size = 0) {
+    const std::lock_guard lock(write_mutex);
+    protocol::Send(socket, type, head, head_size, tail, tail_size);
+  }
+
+  template <typename T> void Send(protocol::Type type, const T &payload) {
+    Send(type, &payload, sizeof(payload));
+  }
+};
+
+/** Records are published in batches to keep lock traffic low. */
+static constexpr std::size_t PUBLISH_BATCH = 256;
+
+/** Largest batch sent in one `Records` message. */
+static constexpr std::size_t SEND_BATCH = 4096;
+
+/** Finished runs without readers kept for late attaches. */
+static constexpr std::size_t MAX_FINISHED_RUNS = 64;
+static constexpr std::chrono::minutes FINISHED_RUN_LIFETIME{30};
+
+/** Compute all iterations of `run` and publish them as they come in. */
+template <std::size_t N>
+void compute(Run &run, FunctionPtr<N> funktion, const CMyVektor<N> &start,
+             double step_size, std::size_t max_iterations) {
+  std::vector<uint8_t> pending;
+  std::size_t pending_count = 0;
+  auto publish = [&](bool finished) {
+    {
+      const std::lock_guard lock(run.mutex);
+      run.data.insert(run.data.end(), pending.begin(), pending.end());
+      run.size += pending_count;
+      run.finished = finished;
+      if (finished) {
+        run.finished_at = std::chrono::steady_clock::now();
+      }
+    }
+    run.changed.notify_all();
+    pending.clear();
+    pending_count = 0;
+  };
+
+  auto iteration = IterationData<N>::AtPoint(start, funktion, step_size, 0);
+  while (true) {
+    protocol::EncodeIteration(iteration, pending);
+    pending_count++;
+    if (iteration.done(max_iterations)) {
+      break;
+    }
+    if (pending_count == PUBLISH_BATCH) {
+      publish(false);
+    }
+    iteration = IterationData<N>::Next(iteration);
+  }
+  publish(true);
+}
+
+class Server {
+public:
+  explicit Server(const std::string &endpoint)
+      : listener(Socket::Listen(endpoint)) {}
+
+  ~Server() {
+    for (auto &run : runs) {
+      if (run.worker.joinable()) {
+        run.worker.join();
+      }
+    }
+  }
+
+  /** Accept and serve clients forever. */
+  [[noreturn]] void Serve() {
+    while (true) {
+      std::thread(&Server::handle_client, this, listener.Accept()).detach();
+    }
+  }
+
+private:
+  Socket listener;
+  JobService jobs{};
+
+  /** Protects `runs`, `next_run_id` and `Run::readers`. Only runs without
+   * readers are removed, so references held by readers stay valid. */
+  std::mutex runs_mutex{};
+  std::list<Run> runs{};
+  uint32_t next_run_id{1};
+
+  /** Marks a run as streamed for its lifetime. */
+  class Reader {
+  public:
+    Reader(Server &server, Run &run) : server(server), run(run) {}
+    ~Reader() { server.release(run); }
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    Server &server;
+    Run &run;
+  };
+
+  void release(Run &run) {
+    const std::lock_guard lock(runs_mutex);
+    run.readers--;
+    evict();
+  }
+
+  /** Drop finished runs without readers that are too old or beyond the
+   * newest `MAX_FINISHED_RUNS`. Called with `runs_mutex` held. */
+  void evict() {
+    const auto now = std::chrono::steady_clock::now();
+    std::size_t kept = 0;
+    for (auto it = runs.rbegin(); it != runs.rend();) {
+      Run &run = *it;
+      bool finished = false;
+      std::chrono::steady_clock::time_point finished_at{};
+      {
+        const std::lock_guard lock(run.mutex);
+        finished = run.finished;
+        finished_at = run.finished_at;
+      }
+      if (!finished || run.readers > 0) {
+        ++it;
+        continue;
+      }
+      if (kept < MAX_FINISHED_RUNS &&
+          now - finished_at < FINISHED_RUN_LIFETIME) {
+        kept++;
+        ++it;
+        continue;
+      }
+      /* Finished, so the worker is about to return. */
+      run.worker.join();
+      std::cout << "Run " << run.id << " dropped" << std::endl;
+      it = std::make_reverse_iterator(runs.erase(std::next(it).base()));
+    }
+  }
+
+  /** Start the run requested by `payload`, which passed `check_options`.
+   * The caller is its first reader. */
+  Run &start_run(const std::vector<uint8_t> &payload) {
+    const auto request = protocol::Read<protocol::StartRun>(payload);
+    const std::size_t dim = protocol::dimension(request.objective);
+    if (payload.size() != sizeof(request) + dim * sizeof(double)) {
+      throw std::runtime_error("StartRun has wrong start point dimension");
+    }
+    const uint8_t *start = payload.data() + sizeof(request);
+
+    const std::lock_guard lock(runs_mutex);
+    evict();
+    Run &run = runs.emplace_back();
+    run.id = next_run_id++;
+    run.dim = dim;
+    run.readers = 1;
+    if (request.objective == protocol::Objective::F) {
+      CMyVektor<2> x;
+      std::memcpy(x.data(), start, sizeof(x));
+      run.worker = std::thread(compute<2>, std::ref(run), functions::f, x,
+                               request.step_size, request.max_iterations);
+    } else {
+      CMyVektor<3> x;
+      std::memcpy(x.data(), start, sizeof(x));
+      run.worker = std::thread(compute<3>, std::ref(run), functions::g, x,
+                               request.step_size, request.max_iterations);
+    }
+    std::cout << "Run " << run.id << " started" << std::endl;
+    return run;
+  }
+
+  /** Run `id` with the caller counted as reader, `nullptr` if there is
+   * none. */
+  Run *find_run(uint32_t id) {
+    const std::lock_guard lock(runs_mutex);
+    for (auto &run : runs) {
+      if (run.id == id) {
+        run.readers++;
+        return &run;
+      }
+    }
+    return nullptr;
+  }
+
+  /** Send all records of `run` from `from_index` on until it is finished.
+   * An index past the records computed so far is answered with `Error`. */
+  static void stream(Connection &client, Run &run, std::size_t from_index) {
+    const std::size_t record_size = protocol::record_size(run.dim);
+    std::size_t available = 0;
+    {
+      const std::lock_guard lock(run.mutex);
+      available = run.size;
+    }
+    if (from_index > available) {
+      const std::string message =
+          "Run " + std::to_string(run.id) + " has only " +
+          std::to_string(available) + " iterations, cannot attach at " +
+          std::to_string(from_index);
+      client.Send(protocol::Type::Error, message.data(), message.size());
+      return;
+    }
+    client.Send(protocol::Type::RunStarted,
+                protocol::RunStarted{run.id, static_cast<uint32_t>(run.dim)});
+    std::vector<uint8_t> batch;
+    std::size_t sent = from_index;
+    while (true) {
+      protocol::Records header{run.id, static_cast<uint32_t>(run.dim), sent,
+                               0};
+      bool finished = false;
+      {
+        std::unique_lock lock(run.mutex);
+        run.changed.wait(lock,
+                         [&] { return run.size > sent || run.finished; });
+        const std::size_t end = std::min(run.size, sent + SEND_BATCH);
+        header.count = end > sent ? end - sent : 0;
+        batch.assign(run.data.begin() +
+                         static_cast<std::ptrdiff_t>(sent * record_size),
+                     run.data.begin() +
+                         static_cast<std::ptrdiff_t>(end * record_size));
+        finished = run.finished && end == run.size;
+      }
+      if (header.count > 0) {
+        client.Send(protocol::Type::Records, &header, sizeof(header),
+                    batch.data(), batch.size());
+        sent += header.count;
+      }
+      if (finished) {
+        client.Send(protocol::Type::RunEnd, protocol::RunEnd{run.id, 0, sent});
+        return;
+      }
+    }
+  }
+
+  /** Answer `Error` and return false unless the objective of a request is
+   * known and its options are in range. Unlike malformed messages, this
+   * keeps the connection open. */
+  static bool check_options(Connection &client, const std::string &request,
+                            protocol::Objective objective, double step_size,
+                            uint64_t max_iterations) {
+    try {
+      protocol::CheckOptions(objective, step_size, max_iterations);
+      return true;
+    } catch (const std::runtime_error &e) {
+      const std::string message = request + ": " + e.what();
+      client.Send(protocol::Type::Error, message.data(), message.size());
+      return false;
+    }
+  }
+
+  /** Queue an `Optimize` job and answer it from the workers when done. */
+  void submit_job(const std::shared_ptr<Connection> &client,
+                  const std::vector<uint8_t> &payload) {
+    const auto request = protocol::Read<protocol::Optimize>(payload);
+    if (!check_options(*client, "Job " + std::to_string(request.job_id),
+                       request.objective, request.step_size,
+                       request.max_iterations)) {
+      return;
+    }
+    const std::size_t dim = protocol::dimension(request.objective);
+    const std::size_t point_size = dim * sizeof(double);
+    const std::size_t points = (payload.size() - sizeof(request)) / point_size;
+    if (points != request.count ||
+        payload.size() != sizeof(request) + points * point_size) {
+      throw std::runtime_error("Optimize has wrong start point count");
+    }
+    jobs.Submit(request, payload.data() + sizeof(request),
+                [client](std::vector<uint8_t> &&results) {
+                  try {
+                    client->Send(protocol::Type::Results, results.data(),
+                                 results.size());
+                  } catch (const std::exception &) {
+                    /* The client is gone, its reader reports that. */
+                  }
+                });
+  }
+
+  void handle_client(Socket socket) {
+    const auto client = std::make_shared<Connection>(std::move(socket));
+    try {
+      protocol::Header header{};
+      std::vector<uint8_t> payload;
+      while (protocol::Receive(client->socket, header, payload)) {
+        switch (header.type) {
+        case protocol::Type::StartRun: {
+          const auto request = protocol::Read<protocol::StartRun>(payload);
+          if (!check_options(*client, "StartRun", request.objective,
+                             request.step_size, request.max_iterations)) {
+            break;
+          }
+          const Reader reader(*this, start_run(payload));
+          stream(*client, reader.run, 0);
+          break;
+        }
+        case protocol::Type::Attach: {
+          const auto request = protocol::Read<protocol::Attach>(payload);
+          Run *run = find_run(request.run_id);
+          if (run == nullptr) {
+            const std::string message =
+                "Unknown run " + std::to_string(request.run_id);
+            client->Send(protocol::Type::Error, message.data(),
+                         message.size());
+            break;
+          }
+          const Reader reader(*this, *run);
+          stream(*client, *run, request.from_index);
+          break;
+        }
+        case protocol::Type::Optimize:
+          submit_job(client, payload);
+          break;
+        default:
+          throw std::runtime_error("Unexpected message type");
+        }
+      }
+    } catch (const std::exception &e) {
+      /* The client is gone or misbehaved. Runs keep going regardless. */
+      std::cerr << "Client error: " << e.what() << std::endl;
+    }
+  }
+};
+} // namespace
+
+auto main(int argc, char **argv) -> int {
+  const std::string endpoint =
+      argc > 1 ? argv[1] : "unix:/tmp/plottings.sock";
+  try {
+    Server server(endpoint);
+    std::cout << "Listening on " << endpoint << std::endl;
+    server.Serve();
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
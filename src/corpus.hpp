@@ -0,0 +1,68 @@
+#ifndef CORPUS_H_
+#define CORPUS_H_
+/**
+ * @file corpus.hpp
+ *
+ * @brief Standard test functions for benchmarking the optimizers.
+ *
+ * `gradient_descent` maximizes, so the usual minimization test functions are
+ * negated. All of them have their global maximum 0.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include <cmath>
+#include <numbers>
+
+namespace corpus {
+/** Negated sphere, -sum x_i^2. Maximum at 0. */
+template <std::size_t N> double sphere(const CMyVektor<N> &x) {
+  double sum = 0.0;
+  for (const double e : x) {
+    sum += e * e;
+  }
+  return -sum;
+}
+
+/** Negated Rosenbrock function. Maximum in a narrow curved valley at
+ * (1, ..., 1). */
+template <std::size_t N> double rosenbrock(const CMyVektor<N> &x) {
+  double sum = 0.0;
+  for (std::size_t i = 0; i + 1 < N; i++) {
+    const double a = x[i + 1] - x[i] * x[i];
+    const double b = 1.0 - x[i];
+    sum += 100.0 * a * a + b * b;
+  }
+  return -sum;
+}
+
+/** Negated Rastrigin function. Many local maxima, the global one at 0. */
+template <std::size_t N> double rastrigin(const CMyVektor<N> &x) {
+  double sum = 10.0 * static_cast<double>(N);
+  for (const double e : x) {
+    sum += e * e - 10.0 * std::cos(2.0 * std::numbers::pi * e);
+  }
+  return -sum;
+}
+
+/** A test function and the box start points are drawn from. */
+template <std::size_t N> struct Problem {
+  const char *name;
+  FunctionPtr<N> funktion;
+  /** Value of the global maximum. */
+  double optimum;
+  /** Start points lie in [lower, upper]^N. */
+  double lower;
+  double upper;
+};
+
+/** All test functions in dimension `N`. */
+template <std::size_t N> constexpr Problem<N> PROBLEMS[] = {
+    {"sphere", sphere<N>, 0.0, -5.0, 5.0},
+    {"rosenbrock", rosenbrock<N>, 0.0, -2.0, 2.0},
+    {"rastrigin", rastrigin<N>, 0.0, -5.12, 5.12},
+};
+} // namespace corpus
+
+#endif // CORPUS_H_
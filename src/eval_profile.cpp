@@ -0,0 +1,172 @@
+/**
+ * @file eval_profile.cpp
+ *
+ * @brief Per-thread evaluation shards and their summary.
+ *
+ * Only built with evaluation profiling enabled, see eval_profile.hpp.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "eval_profile.hpp"
+#include "alloc_counter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+
+namespace eval_profile {
+namespace {
+/** Counters of one thread. Written by the owning thread only, so plain
+ * relaxed loads and stores suffice. Aligned so that neighbouring shards do
+ * not share cache lines. */
+struct alignas(64) Shard {
+  struct Counters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> nanoseconds{0};
+    std::array<std::atomic<uint64_t>, BUCKETS> histogram{};
+  };
+  std::array<Counters, SITES> sites{};
+  /** Intrusive list of live shards, protected by the registry mutex. */
+  Shard *next{nullptr};
+
+  void AddTo(Summary &summary) const {
+    for (std::size_t s = 0; s < SITES; s++) {
+      const Counters &from = sites[s];
+      SiteTotals &to = summary.sites[s];
+      to.calls += from.calls.load(std::memory_order_relaxed);
+      to.nanoseconds += from.nanoseconds.load(std::memory_order_relaxed);
+      for (std::size_t b = 0; b < BUCKETS; b++) {
+        to.histogram[b] += from.histogram[b].load(std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+void increment(std::atomic<uint64_t> &counter, uint64_t amount) {
+  counter.store(counter.load(std::memory_order_relaxed) + amount,
+                std::memory_order_relaxed);
+}
+
+void subtract(Summary &summary, const Summary &baseline) {
+  for (std::size_t s = 0; s < SITES; s++) {
+    SiteTotals &to = summary.sites[s];
+    const SiteTotals &from = baseline.sites[s];
+    to.calls -= from.calls;
+    to.nanoseconds -= from.nanoseconds;
+    for (std::size_t b = 0; b < BUCKETS; b++) {
+      to.histogram[b] -= from.histogram[b];
+    }
+  }
+}
+
+/** All shards. Never destroyed, so threads ending during static
+ * destruction can still retire their shard. */
+struct Registry {
+  std::mutex mutex{};
+  Shard *live{nullptr};
+  /** Totals of finished threads. */
+  Summary retired{};
+  /** Totals at the last `Reset`. */
+  Summary baseline{};
+
+  [[nodiscard]] Summary Totals() const {
+    Summary summary = retired;
+    for (const Shard *shard = live; shard != nullptr; shard = shard->next) {
+      shard->AddTo(summary);
+    }
+    return summary;
+  }
+};
+
+Registry &registry() {
+  static Registry *const instance = new Registry();
+  return *instance;
+}
+
+/** Registers the shard of a thread on first use and retires it when the
+ * thread ends. */
+class LocalShard {
+public:
+  LocalShard() {
+    Registry &reg = registry();
+    const std::lock_guard lock(reg.mutex);
+    shard.next = reg.live;
+    reg.live = &shard;
+  }
+
+  ~LocalShard() {
+    Registry &reg = registry();
+    const std::lock_guard lock(reg.mutex);
+    shard.AddTo(reg.retired);
+    for (Shard **link = &reg.live; *link != nullptr; link = &(*link)->next) {
+      if (*link == &shard) {
+        *link = shard.next;
+        break;
+      }
+    }
+  }
+
+  LocalShard(const LocalShard &) = delete;
+  LocalShard &operator=(const LocalShard &) = delete;
+
+  Shard shard{};
+};
+} // namespace
+
+void Record(Site site, uint64_t nanoseconds) {
+  /* The registry is created on first use, inside the profiled code. */
+  ALLOC_UNCOUNTED_SCOPE();
+  thread_local LocalShard local;
+  Shard::Counters &counters =
+      local.shard.sites[static_cast<std::size_t>(site)];
+  increment(counters.calls, 1);
+  increment(counters.nanoseconds, nanoseconds);
+  const std::size_t bucket =
+      nanoseconds < 2 ? 0
+                      : std::min<std::size_t>(BUCKETS - 1,
+                                              std::bit_width(nanoseconds) - 1);
+  increment(counters.histogram[bucket], 1);
+}
+
+Summary Collect() {
+  Registry &reg = registry();
+  const std::lock_guard lock(reg.mutex);
+  Summary summary = reg.Totals();
+  subtract(summary, reg.baseline);
+  return summary;
+}
+
+void Reset() {
+  Registry &reg = registry();
+  const std::lock_guard lock(reg.mutex);
+  reg.baseline = reg.Totals();
+}
+
+void Print(std::FILE *out, const Summary &summary, uint64_t iterations) {
+  std::fprintf(out, "%-10s %12s %10s %10s %10s %10s\n", "Site", "Calls",
+               "Calls/it", "Mean [ns]", "p50 [ns]", "p99 [ns]");
+  for (std::size_t s = 0; s < SITES; s++) {
+    const SiteTotals &site = summary.sites[s];
+    if (site.calls == 0) {
+      continue;
+    }
+    char per_iteration[32] = "-";
+    if (iterations > 0) {
+      std::snprintf(per_iteration, sizeof(per_iteration), "%.2f",
+                    static_cast<double>(site.calls) /
+                        static_cast<double>(iterations));
+    }
+    std::fprintf(out, "%-10s %12llu %10s %10.0f %10llu %10llu\n",
+                 SITE_NAMES[s], static_cast<unsigned long long>(site.calls),
+                 per_iteration, site.mean_nanoseconds(),
+                 static_cast<unsigned long long>(
+                     site.quantile_nanoseconds(0.5)),
+                 static_cast<unsigned long long>(
+                     site.quantile_nanoseconds(0.99)));
+  }
+  std::fprintf(out, "%-10s %12llu\n", "total",
+               static_cast<unsigned long long>(summary.calls()));
+}
+} // namespace eval_profile
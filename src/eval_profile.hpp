@@ -0,0 +1,154 @@
+#ifndef EVAL_PROFILE_H_
+#define EVAL_PROFILE_H_
+/**
+ * @file eval_profile.hpp
+ *
+ * @brief Count and time objective evaluations per call site.
+ *
+ * Compiled in with `-DPLOTTINGS_EVAL_PROFILE=1`, e.g. through the CMake cache
+ * variable of the same name. Otherwise `EVAL_PROFILE_SCOPE` expands to
+ * nothing, eval_profile.cpp is not built and `evaluate` in cmyvektor.hpp is
+ * a plain call.
+ *
+ * Every evaluation through `evaluate` is attributed to a `Site` and adds its
+ * wall time to a latency histogram with power-of-two buckets. Each thread
+ * counts into its own cache-line aligned shard without locking, `Collect`
+ * sums all shards. Shards of finished threads are folded into a total, so
+ * short-lived workers are not lost.
+ *
+ * The headless mode prints the numbers after its results, the UI shows them
+ * in a collapsible section.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace eval_profile {
+/** Where an objective evaluation comes from. */
+enum class Site : uint8_t {
+  /** Neighbours and centre in `CMyVektor::gradient`. */
+  Gradient,
+  /** Iteration points: current, next and test points. */
+  Point,
+  Heatmap,
+  /** Exact value under the mouse cursor. */
+  Probe,
+  Other,
+};
+
+inline constexpr std::size_t SITES = 5;
+
+inline constexpr const char *SITE_NAMES[SITES] = {"gradient", "point",
+                                                  "heatmap", "probe", "other"};
+
+/** Bucket b holds durations in [2^b, 2^(b+1)) ns, the first one also 0 ns
+ * and the last one everything from about nine minutes on. */
+inline constexpr std::size_t BUCKETS = 40;
+
+struct SiteTotals {
+  uint64_t calls{0};
+  uint64_t nanoseconds{0};
+  std::array<uint64_t, BUCKETS> histogram{};
+
+  [[nodiscard]] double mean_nanoseconds() const {
+    return calls == 0 ? 0.0
+                      : static_cast<double>(nanoseconds) /
+                            static_cast<double>(calls);
+  }
+
+  /** Upper bound of the bucket holding quantile `q` in [0, 1], in ns. */
+  [[nodiscard]] uint64_t quantile_nanoseconds(double q) const;
+};
+
+struct Summary {
+  std::array<SiteTotals, SITES> sites{};
+
+  [[nodiscard]] const SiteTotals &operator[](Site site) const {
+    return sites[static_cast<std::size_t>(site)];
+  }
+
+  [[nodiscard]] uint64_t calls() const;
+};
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+
+inline uint64_t SiteTotals::quantile_nanoseconds(double q) const {
+  if (calls == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::min(
+      calls - 1, static_cast<uint64_t>(q * static_cast<double>(calls)));
+  uint64_t seen = 0;
+  for (std::size_t b = 0; b + 1 < BUCKETS; b++) {
+    seen += histogram[b];
+    if (seen > rank) {
+      return uint64_t{2} << b;
+    }
+  }
+  return uint64_t{2} << (BUCKETS - 1);
+}
+
+inline uint64_t Summary::calls() const {
+  uint64_t total = 0;
+  for (const auto &site : sites) {
+    total += site.calls;
+  }
+  return total;
+}
+} // namespace eval_profile
+
+#if defined(PLOTTINGS_EVAL_PROFILE) && PLOTTINGS_EVAL_PROFILE > 0
+#include <chrono>
+
+namespace eval_profile {
+/** Add one evaluation of `nanoseconds` at `site` to the calling thread's
+ * shard. */
+void Record(Site site, uint64_t nanoseconds);
+
+/** Totals of all threads since the start or the last `Reset`. */
+[[nodiscard]] Summary Collect();
+
+/** Start counting from zero. Running threads are not interrupted. */
+void Reset();
+
+/**
+ * Print a table of `summary` to `out`. With `iterations` > 0 calls are
+ * also given per iteration.
+ */
+void Print(std::FILE *out, const Summary &summary, uint64_t iterations = 0);
+
+/** Records the time from construction to destruction. */
+class Timer {
+public:
+  explicit Timer(Site site)
+      : site(site), start(std::chrono::steady_clock::now()) {}
+
+  ~Timer() {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    Record(site, static_cast<uint64_t>(
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         elapsed)
+                         .count()));
+  }
+
+  Timer(const Timer &) = delete;
+  Timer &operator=(const Timer &) = delete;
+
+private:
+  Site site;
+  std::chrono::steady_clock::time_point start;
+};
+} // namespace eval_profile
+
+#define EVAL_PROFILE_SCOPE(site)                                               \
+  const eval_profile::Timer eval_profile_timer { site }
+#else
+#define EVAL_PROFILE_SCOPE(site) static_cast<void>(0)
+#endif
+
+#endif // EVAL_PROFILE_H_
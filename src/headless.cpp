@@ -0,0 +1,403 @@
+/**
+ * @file headless.cpp
+ *
+ * @brief Implementation of the headless command line mode.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "headless.hpp"
+#include "batch.hpp"
+#include "eval_profile.hpp"
+#include "functions.hpp"
+#include "memo_cache.hpp"
+#include "sampler.hpp"
+#include "worker_pool.hpp"
+#include "writer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace {
+/** Task start points and step sizes used if none are given. */
+constexpr CMyVektor<2> TASK_START_F{0.2, -2.1};
+constexpr double TASK_STEP_SIZE_F = 1.0;
+constexpr CMyVektor<3> TASK_START_G{0.0, 0.0, 0.0};
+constexpr double TASK_STEP_SIZE_G = 0.1;
+
+/** Default number of points in flight per worker thread. Enough to keep
+ * the workers busy while results are written. */
+constexpr std::size_t BATCH_IN_FLIGHT_PER_THREAD = 16;
+
+constexpr const char *USAGE =
+    "usage: plottings --headless [--objective f|g] [--start x,y[,z]]...\n"
+    "                 [--input <file|->] [--threads <n>]\n"
+    "                 [--max-in-flight <n>]\n"
+    "                 [--optimizer gradient-descent] [--step-size <lambda>]\n"
+    "                 [--max-iterations <n>]\n"
+    "                 [--format text|csv|jsonl|binary]\n"
+    "                 [--output <file>] [--worker <command>]\n"
+    "                 [--worker-processes <n>] [--worker-timeout <ms>]\n"
+    "                 [--memoize <entries>]\n"
+    "                 [--sample sobol|halton|lhs] [--samples <n>]\n"
+    "                 [--bounds <min>,<max>] [--seed <n>] [--estimate <n>]\n"
+    "       plottings-cli takes the same arguments.\n";
+
+/** Optimizer called `name`, `nullptr` if there is none. */
+template <std::size_t N> OptimizerPtr<N> find_optimizer(std::string_view name) {
+  for (const auto &optimizer : OPTIMIZERS<N>) {
+    if (name == optimizer.name) {
+      return optimizer.optimize;
+    }
+  }
+  return nullptr;
+}
+
+/** Parse all of `text` as number. */
+template <typename T> T parse_number(std::string_view text, const char *what) {
+  T value{};
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    throw std::runtime_error(std::string("Invalid ") + what + " '" +
+                             std::string(text) + "'");
+  }
+  return value;
+}
+
+/** Parse comma-separated coordinates. */
+std::vector<double> parse_point(std::string_view text) {
+  std::vector<double> point;
+  while (true) {
+    const std::size_t comma = text.find(',');
+    point.push_back(parse_number<double>(text.substr(0, comma), "coordinate"));
+    if (comma == std::string_view::npos) {
+      return point;
+    }
+    text.remove_prefix(comma + 1);
+  }
+}
+
+/** Split `command` at spaces. */
+std::vector<std::string> split_command(std::string_view command) {
+  std::vector<std::string> args;
+  while (!command.empty()) {
+    const std::size_t space = command.find(' ');
+    if (space != 0) {
+      args.emplace_back(command.substr(0, space));
+    }
+    if (space == std::string_view::npos) {
+      break;
+    }
+    command.remove_prefix(space + 1);
+  }
+  return args;
+}
+
+using File = std::unique_ptr<std::FILE, decltype(&std::fclose)>;
+
+/** Vector with `value` in every coordinate. */
+template <std::size_t N> CMyVektor<N> uniform(double value) {
+  CMyVektor<N> x;
+  x.fill(value);
+  return x;
+}
+
+/** Write the Monte Carlo estimate of `funktion` over the sample box. Each
+ * thread evaluates its own contiguous range of sample indices. */
+template <std::size_t N>
+void write_estimate(FunctionPtr<N> funktion, const HeadlessOptions &options,
+                    OutputBuffer &out) {
+  const Sampler sampler(options.sample.value_or(SamplerKind::Sobol), N,
+                        options.estimate, options.seed);
+  const CMyVektor<N> lower = uniform<N>(options.lower);
+  const CMyVektor<N> upper = uniform<N>(options.upper);
+
+  std::size_t threads = options.threads;
+  if (threads == 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  threads = static_cast<std::size_t>(
+      std::min<uint64_t>(threads, options.estimate));
+  std::vector<std::future<SampleEstimate<N>>> parts;
+  for (std::size_t t = 0; t < threads; t++) {
+    const uint64_t first = options.estimate * t / threads;
+    const uint64_t end = options.estimate * (t + 1) / threads;
+    parts.push_back(std::async(std::launch::async, [&, first, end] {
+      return Estimate<N>(sampler, funktion, lower, upper, first, end - first);
+    }));
+  }
+  SampleEstimate<N> estimate{};
+  for (auto &part : parts) {
+    estimate += part.get();
+  }
+
+  out.Text("samples ");
+  out.Integer(estimate.samples);
+  out.Text("\nmean ");
+  out.Number(estimate.mean());
+  out.Text("\nmaximum ");
+  out.Number(estimate.maximum);
+  out.Text(" at ");
+  for (std::size_t i = 0; i < N; i++) {
+    if (i > 0) {
+      out.Char(',');
+    }
+    out.Number(estimate.argmax[i]);
+  }
+  out.Char('\n');
+}
+
+/** Optimize from every start point and print one result line each. Adds
+ * the iterations of all runs to `iterations`. */
+template <std::size_t N>
+ExitCode solve(FunctionPtr<N> funktion, const CMyVektor<N> &task_start,
+               double task_step_size, const HeadlessOptions &options,
+               OutputBuffer &out, uint64_t &iterations) {
+  const double step_size = options.step_size.value_or(task_step_size);
+  const OptimizerPtr<N> optimize = find_optimizer<N>(options.optimizer);
+
+  std::optional<WorkerPool> workers;
+  std::optional<ExternalObjective<N>> external;
+  if (!options.worker.empty()) {
+    WorkerPool::Options pool_options{split_command(options.worker),
+                                     options.worker_processes};
+    pool_options.timeout = std::chrono::milliseconds(options.worker_timeout);
+    workers.emplace(std::move(pool_options));
+    external.emplace(*workers);
+    funktion = ExternalObjective<N>::function();
+  }
+  std::optional<MemoizedObjective<N>> memoized;
+  if (options.memoize > 0) {
+    memoized.emplace(funktion, options.memoize);
+    funktion = MemoizedObjective<N>::function();
+  }
+  ResultWriter<N> writer(out, options.format);
+
+  ExitCode status = ExitCode::Converged;
+  const auto write = [&](const RunResult<N> &result) {
+    if (!result.converged) {
+      status = ExitCode::NotConverged;
+    }
+    iterations += result.iterations;
+    writer.Write(result);
+  };
+
+  const auto run_batch = [&](auto &&next) {
+    ThreadPool pool(options.threads);
+    const std::size_t max_in_flight = options.max_in_flight != 0
+                                          ? options.max_in_flight
+                                          : BATCH_IN_FLIGHT_PER_THREAD *
+                                                pool.size();
+    RunBatch<N>(pool, max_in_flight, next, optimize, funktion, step_size,
+                options.max_iterations, write);
+  };
+
+  if (options.estimate > 0) {
+    write_estimate<N>(funktion, options, out);
+  } else if (options.sample) {
+    const Sampler sampler(*options.sample, N, options.samples, options.seed);
+    SamplePoints<N> points(sampler, uniform<N>(options.lower),
+                           uniform<N>(options.upper), 0, options.samples);
+    run_batch([&](CMyVektor<N> &start) { return points.Next(start); });
+  } else if (options.input.empty()) {
+    /* Few points from the command line, no need for workers. */
+    if (options.starts.empty()) {
+      write(optimize(task_start, funktion, step_size, options.max_iterations));
+    }
+    for (const auto &coordinates : options.starts) {
+      CMyVektor<N> start{};
+      std::copy(coordinates.begin(), coordinates.end(), start.begin());
+      write(optimize(start, funktion, step_size, options.max_iterations));
+    }
+  } else {
+    StartPointReader reader(options.input);
+    std::vector<double> coordinates;
+    const auto next = [&](CMyVektor<N> &start) {
+      if (!reader.Next(coordinates)) {
+        return false;
+      }
+      if (coordinates.size() != N) {
+        throw std::runtime_error(
+            "Line " + std::to_string(reader.line()) + " has " +
+            std::to_string(coordinates.size()) + " coordinates, expected " +
+            std::to_string(N));
+      }
+      std::copy(coordinates.begin(), coordinates.end(), start.begin());
+      return true;
+    };
+    run_batch(next);
+  }
+
+  if (memoized) {
+    const MemoStats stats = memoized->stats();
+    std::fprintf(stderr,
+                 "Memoized evaluations: %llu hits, %llu misses (%.1f %%), "
+                 "%llu evictions\n",
+                 static_cast<unsigned long long>(stats.hits),
+                 static_cast<unsigned long long>(stats.misses),
+                 100.0 * stats.hit_rate(),
+                 static_cast<unsigned long long>(stats.evictions));
+  }
+  return status;
+}
+} // namespace
+
+HeadlessOptions ParseHeadless(int argc, char **argv) {
+  HeadlessOptions options{};
+  for (int i = 0; i < argc; i += 2) {
+    const std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      throw std::runtime_error("Missing value for '" + std::string(arg) + "'");
+    }
+    const std::string_view value = argv[i + 1];
+    if (arg == "--objective") {
+      options.objective = value;
+    } else if (arg == "--start") {
+      options.starts.push_back(parse_point(value));
+    } else if (arg == "--input") {
+      options.input = value;
+    } else if (arg == "--threads") {
+      options.threads = parse_number<std::size_t>(value, "thread count");
+    } else if (arg == "--max-in-flight") {
+      options.max_in_flight =
+          parse_number<std::size_t>(value, "in-flight limit");
+    } else if (arg == "--optimizer") {
+      options.optimizer = value;
+    } else if (arg == "--step-size") {
+      options.step_size = parse_number<double>(value, "step size");
+    } else if (arg == "--max-iterations") {
+      options.max_iterations =
+          parse_number<std::size_t>(value, "iteration limit");
+    } else if (arg == "--format") {
+      options.format = parse_output_format(value);
+    } else if (arg == "--output") {
+      options.output = value;
+    } else if (arg == "--worker") {
+      options.worker = value;
+    } else if (arg == "--worker-processes") {
+      options.worker_processes =
+          parse_number<std::size_t>(value, "worker process count");
+    } else if (arg == "--worker-timeout") {
+      options.worker_timeout =
+          parse_number<std::size_t>(value, "worker timeout");
+    } else if (arg == "--memoize") {
+      options.memoize = parse_number<std::size_t>(value, "cache size");
+    } else if (arg == "--sample") {
+      options.sample = parse_sampler_kind(value);
+    } else if (arg == "--samples") {
+      options.samples = parse_number<uint64_t>(value, "sample count");
+    } else if (arg == "--bounds") {
+      const std::vector<double> bounds = parse_point(value);
+      if (bounds.size() != 2 || !(bounds[0] < bounds[1])) {
+        throw std::runtime_error("Invalid bounds '" + std::string(value) +
+                                 "', expected <min>,<max> with min < max");
+      }
+      options.lower = bounds[0];
+      options.upper = bounds[1];
+    } else if (arg == "--seed") {
+      options.seed = parse_number<uint64_t>(value, "seed");
+    } else if (arg == "--estimate") {
+      options.estimate = parse_number<uint64_t>(value, "sample count");
+    } else {
+      throw std::runtime_error("Unknown argument '" + std::string(arg) + "'");
+    }
+  }
+
+  if (options.objective != "f" && options.objective != "g") {
+    throw std::runtime_error("Unknown objective '" + options.objective + "'");
+  }
+  if (!options.input.empty() && !options.starts.empty()) {
+    throw std::runtime_error("--start and --input are exclusive");
+  }
+  if ((options.sample || options.estimate > 0) &&
+      (!options.input.empty() || !options.starts.empty())) {
+    throw std::runtime_error(
+        "--sample and --estimate exclude --start and --input");
+  }
+  if (options.samples == 0) {
+    throw std::runtime_error("Sample count must be positive");
+  }
+  const std::size_t dimension = options.objective == "f" ? 2 : 3;
+  for (const auto &start : options.starts) {
+    if (start.size() != dimension) {
+      throw std::runtime_error("Start point dimension " +
+                               std::to_string(start.size()) +
+                               " does not match the objective (" +
+                               std::to_string(dimension) + ")");
+    }
+    if (!std::all_of(start.begin(), start.end(),
+                     [](double x) { return std::isfinite(x); })) {
+      throw std::runtime_error("Start point coordinates must be finite");
+    }
+  }
+  if (find_optimizer<2>(options.optimizer) == nullptr) {
+    throw std::runtime_error("Unknown optimizer '" + options.optimizer + "'");
+  }
+  if (options.step_size &&
+      (!std::isfinite(*options.step_size) || *options.step_size <= 0.0)) {
+    throw std::runtime_error("Step size must be finite and positive");
+  }
+  if (options.max_iterations == 0) {
+    throw std::runtime_error("Iteration limit must be positive");
+  }
+  if (!options.worker.empty() && split_command(options.worker).empty()) {
+    throw std::runtime_error("Worker command is empty");
+  }
+  return options;
+}
+
+int RunHeadless(int argc, char **argv) {
+  if (argc == 1 && std::string_view(argv[0]) == "--help") {
+    std::fputs(USAGE, stdout);
+    return static_cast<int>(ExitCode::Converged);
+  }
+
+  HeadlessOptions options;
+  try {
+    options = ParseHeadless(argc, argv);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n%s", e.what(), USAGE);
+    return static_cast<int>(ExitCode::Usage);
+  }
+
+  try {
+    File file{nullptr, &std::fclose};
+    if (!options.output.empty()) {
+      file.reset(std::fopen(options.output.c_str(), "w"));
+      if (!file) {
+        throw std::runtime_error("Could not open '" + options.output + "'");
+      }
+    }
+    OutputBuffer out(file ? file.get() : stdout);
+
+    uint64_t iterations = 0;
+    const ExitCode status =
+        options.objective == "f"
+            ? solve<2>(functions::f, TASK_START_F, TASK_STEP_SIZE_F, options,
+                       out, iterations)
+            : solve<3>(functions::g, TASK_START_G, TASK_STEP_SIZE_G, options,
+                       out, iterations);
+    out.Flush();
+#if defined(PLOTTINGS_EVAL_PROFILE) && PLOTTINGS_EVAL_PROFILE > 0
+    std::fprintf(stderr, "Objective evaluations, %llu iterations:\n",
+                 static_cast<unsigned long long>(iterations));
+    eval_profile::Print(stderr, eval_profile::Collect(), iterations);
+#endif
+    return static_cast<int>(status);
+  } catch (const std::runtime_error &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return static_cast<int>(ExitCode::Failure);
+  }
+}
@@ -0,0 +1,112 @@
+#ifndef HEADLESS_H_
+#define HEADLESS_H_
+/**
+ * @file headless.hpp
+ *
+ * @brief Command line mode that optimizes without a window.
+ *
+ *   plottings --headless [--objective f|g] [--start x,y[,z]]...
+ *             [--input <file|->] [--threads <n>] [--max-in-flight <n>]
+ *             [--optimizer gradient-descent] [--step-size <lambda>]
+ *             [--max-iterations <n>] [--format text|csv|jsonl|binary]
+ *             [--output <file>] [--worker <command>]
+ *             [--worker-processes <n>] [--worker-timeout <ms>]
+ *             [--memoize <entries>]
+ *             [--sample sobol|halton|lhs] [--samples <n>]
+ *             [--bounds <min>,<max>] [--seed <n>] [--estimate <n>]
+ *
+ * Every `--start` is one run. Without any, the start point of the exercise
+ * task is used. `--input` instead streams start points from a file or
+ * standard input through the batch runner of batch.hpp. `--worker`
+ * evaluates the objective in external worker processes, see
+ * worker_pool.hpp. `--objective` then only selects the dimension and the
+ * task defaults. Workers that do not answer within `--worker-timeout` are
+ * restarted, 0 waits forever. `--memoize` caches objective values, see
+ * memo_cache.hpp, and prints the hit rate to standard error. `--sample`
+ * takes `--samples` start points from a low-discrepancy sampler in the box
+ * [min, max]^N, see sampler.hpp. `--estimate` prints the mean and the
+ * largest value of the objective at that many points of the box instead of
+ * optimizing. Nothing in here touches GLFW or OpenGL, and no work is done
+ * before the arguments are parsed, so the mode starts as fast as the
+ * process itself.
+ * `plottings-cli` runs the same mode in builds without the GUI.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "iteration.hpp"
+#include "sampler.hpp"
+#include "writer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/** Process exit status of the headless mode. */
+enum class ExitCode : int {
+  /** All runs converged. */
+  Converged = 0,
+  /** At least one run hit the iteration limit. */
+  NotConverged = 1,
+  /** Invalid arguments. */
+  Usage = 2,
+  /** Runtime error, e.g. the output file could not be written. */
+  Failure = 3,
+};
+
+/** Arguments of the headless mode. */
+struct HeadlessOptions {
+  /** Name of the objective in `functions`. */
+  std::string objective{"f"};
+  /** Start points. Their dimension must match the objective. */
+  std::vector<std::vector<double>> starts{};
+  /** Start point file, "-" for standard input. Empty if not streaming. */
+  std::string input{};
+  /** Worker threads for `input`. Zero means one per hardware thread. */
+  std::size_t threads{0};
+  /** Points read but not yet written. Zero picks a multiple of `threads`. */
+  std::size_t max_in_flight{0};
+  std::string optimizer{"gradient-descent"};
+  /** Initial step size. Defaults to the objective's task value. */
+  std::optional<double> step_size{};
+  std::size_t max_iterations{IterationData<2>::MAX_ITERATIONS};
+  OutputFormat format{OutputFormat::Text};
+  /** Output file. Standard output if empty. */
+  std::string output{};
+  /** Worker command, split at spaces. In-process objective if empty. */
+  std::string worker{};
+  /** Worker processes. Zero means one per hardware thread. */
+  std::size_t worker_processes{0};
+  /** Longest wait for a worker's answer in milliseconds. Zero waits
+   * forever. */
+  std::size_t worker_timeout{60000};
+  /** Cached objective values. Zero disables the cache. */
+  std::size_t memoize{0};
+  /** Sampler of start points. Not sampling if empty. */
+  std::optional<SamplerKind> sample{};
+  /** Start points taken from `sample`. */
+  uint64_t samples{64};
+  /** Box of the sampled points, the same range in every coordinate. */
+  double lower{-2.0};
+  double upper{2.0};
+  /** Scrambles the sampler, see sampler.hpp. */
+  uint64_t seed{0};
+  /** Points of the Monte Carlo estimate. Zero optimizes instead. */
+  uint64_t estimate{0};
+};
+
+/**
+ * Parse `argc` arguments following `--headless`. Throws
+ * `std::runtime_error` on invalid arguments.
+ */
+[[nodiscard]] HeadlessOptions ParseHeadless(int argc, char **argv);
+
+/**
+ * Run the headless mode with the arguments following `--headless`.
+ *
+ * @returns Process exit status, see `ExitCode`.
+ */
+[[nodiscard]] int RunHeadless(int argc, char **argv);
+
+#endif // HEADLESS_H_
@@ -0,0 +1,215 @@
+/**
+ * @file heatmap.cpp
+ *
+ * @brief Heatmap storage and generation.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "heatmap.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <sys/mman.h>
+
+/* ------------ HeapBuffer -------------------------------------------- */
+HeapBuffer::HeapBuffer(std::size_t size) : size_(size) {
+  if (size >= HUGE_PAGE_SIZE) {
+    /* Round up so the kernel can back the whole mapping with huge pages. */
+    const std::size_t length =
+        (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void *ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr != MAP_FAILED) {
+      madvise(ptr, length, MADV_HUGEPAGE);
+      data_ = ptr;
+      mapping = ptr;
+      mapped_size = length;
+      return;
+    }
+  }
+  if (size > 0) {
+    data_ = ::operator new(size, std::align_val_t{64});
+  }
+}
+
+HeapBuffer::~HeapBuffer() { release(); }
+
+HeapBuffer::HeapBuffer(HeapBuffer &&other) noexcept
+    : data_(other.data_), size_(other.size_), mapping(other.mapping),
+      mapped_size(other.mapped_size) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.mapping = nullptr;
+  other.mapped_size = 0;
+}
+
+HeapBuffer &HeapBuffer::operator=(HeapBuffer &&other) noexcept {
+  if (this != &other) {
+    release();
+    data_ = other.data_;
+    size_ = other.size_;
+    mapping = other.mapping;
+    mapped_size = other.mapped_size;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.mapping = nullptr;
+    other.mapped_size = 0;
+  }
+  return *this;
+}
+
+HeapBuffer HeapBuffer::MapFile(int fd, std::size_t offset, std::size_t size) {
+  const std::size_t length = offset + size;
+  void *ptr =
+      mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  if (ptr == MAP_FAILED) {
+    throw std::runtime_error("Could not map heatmap file");
+  }
+  HeapBuffer ret{};
+  ret.mapping = ptr;
+  ret.mapped_size = length;
+  ret.data_ = static_cast<char *>(ptr) + offset;
+  ret.size_ = size;
+  return ret;
+}
+
+void HeapBuffer::release() {
+  if (data_ == nullptr) {
+    return;
+  }
+  if (mapped_size > 0) {
+    munmap(mapping, mapped_size);
+    mapping = nullptr;
+    mapped_size = 0;
+  } else {
+    ::operator delete(data_, std::align_val_t{64});
+  }
+  data_ = nullptr;
+}
+
+/* ------------ Heatmap ----------------------------------------------- */
+Heatmap::Heatmap(std::size_t resolution, double x_min, double y_min,
+                 double size, HeatmapPrecision precision)
+    : grid_{resolution, x_min, y_min, size}, precision_(precision),
+      buffer(resolution * resolution * element_size(precision)) {}
+
+Heatmap::Heatmap(std::size_t resolution, double x_min, double y_min,
+                 double size, HeatmapPrecision precision, HeapBuffer buffer,
+                 double min, double max)
+    : grid_{resolution, x_min, y_min, size}, precision_(precision),
+      buffer(std::move(buffer)), max_(max), min_(min) {
+  if (this->buffer.size() < bytes()) {
+    throw std::invalid_argument("Heatmap buffer too small");
+  }
+}
+
+double Heatmap::at(std::size_t row, std::size_t column) const {
+  const std::size_t i = row * grid_.resolution + column;
+  switch (precision_) {
+  case HeatmapPrecision::Float64:
+    return static_cast<const double *>(buffer.data())[i];
+  case HeatmapPrecision::Float32:
+    return static_cast<const float *>(buffer.data())[i];
+  case HeatmapPrecision::UNorm16:
+    return min_ + (max_ - min_) *
+                      static_cast<double>(
+                          static_cast<const uint16_t *>(buffer.data())[i]) /
+                      65535.0;
+  }
+  return 0.0;
+}
+
+void Heatmap::set(std::size_t row, std::size_t column, double value) {
+  const std::size_t i = row * grid_.resolution + column;
+  switch (precision_) {
+  case HeatmapPrecision::Float64:
+    static_cast<double *>(buffer.data())[i] = value;
+    break;
+  case HeatmapPrecision::Float32:
+    static_cast<float *>(buffer.data())[i] = static_cast<float>(value);
+    break;
+  case HeatmapPrecision::UNorm16: {
+    const double range = max_ - min_;
+    const double normalized =
+        range > 0.0 ? std::clamp((value - min_) / range, 0.0, 1.0) : 0.0;
+    static_cast<uint16_t *>(buffer.data())[i] =
+        static_cast<uint16_t>(std::lround(normalized * 65535.0));
+    break;
+  }
+  }
+}
+
+void Heatmap::Fill(FunctionPtr<2> funktion) {
+  TRACE_SCOPE("Heatmap::Fill");
+  const std::size_t resolution = grid_.resolution;
+  const std::size_t count = resolution * resolution;
+  max_ = -INFINITY;
+  min_ = INFINITY;
+
+  /* Quantization needs the final range, so 16-bit grids are computed in
+   * single precision first and converted afterwards. */
+  HeapBuffer scratch{};
+  float *staging = nullptr;
+  if (precision_ == HeatmapPrecision::UNorm16) {
+    scratch = HeapBuffer(count * sizeof(float));
+    staging = static_cast<float *>(scratch.data());
+  }
+
+  for (std::size_t row = 0; row < resolution; row++) {
+    for (std::size_t column = 0; column < resolution; column++) {
+      const double value = evaluate(funktion, position(row, column),
+                                    eval_profile::Site::Heatmap);
+      max_ = std::max(max_, value);
+      min_ = std::min(min_, value);
+      if (staging != nullptr) {
+        staging[row * resolution + column] = static_cast<float>(value);
+      } else {
+        set(row, column, value);
+      }
+    }
+  }
+
+  if (staging != nullptr) {
+    for (std::size_t i = 0; i < count; i++) {
+      set(i / resolution, i % resolution, staging[i]);
+    }
+  }
+}
+
+Heatmap::Sample Heatmap::Interpolate(const CMyVektor<2> &x) const {
+  Sample ret{};
+  const std::size_t resolution = grid_.resolution;
+  if (resolution == 0) {
+    return ret;
+  }
+  const double last = static_cast<double>(resolution - 1);
+  /* Fractional column and row. Rows count down from the top edge. */
+  const double column = std::clamp((x[0] - grid_.x_min) / tick(), 0.0, last);
+  const double row =
+      std::clamp((grid_.y_min + grid_.size - x[1]) / tick(), 0.0, last);
+  const auto c0 = static_cast<std::size_t>(column);
+  const auto r0 = static_cast<std::size_t>(row);
+  const std::size_t c1 = std::min(c0 + 1, resolution - 1);
+  const std::size_t r1 = std::min(r0 + 1, resolution - 1);
+  const double fc = column - static_cast<double>(c0);
+  const double fr = row - static_cast<double>(r0);
+
+  const double top_left = at(r0, c0);
+  const double top_right = at(r0, c1);
+  const double bottom_left = at(r1, c0);
+  const double bottom_right = at(r1, c1);
+  const double top = top_left + fc * (top_right - top_left);
+  const double bottom = bottom_left + fc * (bottom_right - bottom_left);
+
+  ret.value = top + fr * (bottom - top);
+  ret.gradient[0] = ((1.0 - fr) * (top_right - top_left) +
+                     fr * (bottom_right - bottom_left)) /
+                    tick();
+  /* y grows upwards, rows grow downwards. */
+  ret.gradient[1] = -(bottom - top) / tick();
+  return ret;
+}
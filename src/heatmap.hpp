@@ -0,0 +1,243 @@
+#ifndef HEATMAP_H_
+#define HEATMAP_H_
+/**
+ * @file heatmap.hpp
+ *
+ * @brief Sampled values of a 2D function on a square grid.
+ *
+ * The grid is stored row-major in a heap buffer. Row 0 is the top row
+ * (largest y), as expected by `ImPlot::PlotHeatmap`. Large grids are put on
+ * transparent huge pages to save TLB misses when the whole grid is read each
+ * frame.
+ *
+ * Doubles are more precision than a colormap can show, so the element type
+ * is selectable:
+ *
+ * - `Float64`: exact values.
+ * - `Float32`: half the memory, about seven significant digits.
+ * - `UNorm16`: a quarter of the memory. Values are quantized to 65536 levels
+ *   between `min()` and `max()`. This is the 16-bit format ImPlot can draw
+ *   directly and more levels than any colormap has.
+ *
+ * Values are converted when the grid is generated.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/** Element type of a heatmap. */
+enum class HeatmapPrecision : uint8_t {
+  Float64 = 0,
+  Float32 = 1,
+  UNorm16 = 2,
+};
+
+/** Size of one element of `precision` in bytes. */
+constexpr auto element_size(HeatmapPrecision precision) -> std::size_t {
+  switch (precision) {
+  case HeatmapPrecision::Float64:
+    return sizeof(double);
+  case HeatmapPrecision::Float32:
+    return sizeof(float);
+  case HeatmapPrecision::UNorm16:
+    return sizeof(uint16_t);
+  }
+  return 0;
+}
+
+/** Parse "f64", "f32" or "u16". Throws `std::invalid_argument` otherwise. */
+inline auto parse_precision(std::string_view name) -> HeatmapPrecision {
+  if (name == "f64") {
+    return HeatmapPrecision::Float64;
+  }
+  if (name == "f32") {
+    return HeatmapPrecision::Float32;
+  }
+  if (name == "u16") {
+    return HeatmapPrecision::UNorm16;
+  }
+  throw std::invalid_argument("Unknown heatmap precision '" +
+                              std::string(name) + "'");
+}
+
+/**
+ * Uninitialized heap memory. Allocations of at least `HUGE_PAGE_SIZE` are
+ * mapped separately and advised to use transparent huge pages.
+ */
+class HeapBuffer {
+public:
+  static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  HeapBuffer() = default;
+  explicit HeapBuffer(std::size_t size);
+  ~HeapBuffer();
+
+  HeapBuffer(const HeapBuffer &) = delete;
+  HeapBuffer &operator=(const HeapBuffer &) = delete;
+  HeapBuffer(HeapBuffer &&other) noexcept;
+  HeapBuffer &operator=(HeapBuffer &&other) noexcept;
+
+  [[nodiscard]] void *data() { return data_; }
+  [[nodiscard]] const void *data() const { return data_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  /** Returns 'true' if the buffer is a memory mapping. */
+  [[nodiscard]] bool mapped() const { return mapped_size > 0; }
+
+  /**
+   * Map `size` bytes at `offset` of the file `fd` copy-on-write, i.e.
+   * writes to the buffer do not change the file. The file is read lazily by
+   * the kernel on first access.
+   *
+   * Throws `std::runtime_error` on failure.
+   */
+  [[nodiscard]] static HeapBuffer MapFile(int fd, std::size_t offset,
+                                          std::size_t size);
+
+private:
+  void *data_{nullptr};
+  std::size_t size_{0};
+  /** Start and size of the mapping, zero for normal heap allocations. */
+  void *mapping{nullptr};
+  std::size_t mapped_size{0};
+
+  void release();
+};
+
+/**
+ * Sample positions of a square `resolution` x `resolution` grid. Cell
+ * (row, column) is sampled at its top left corner; row 0 is the top row.
+ */
+struct HeatmapGrid {
+  /** Grid cells per dimension. */
+  std::size_t resolution{0};
+  /** Left edge. */
+  double x_min{0.0};
+  /** Bottom edge. */
+  double y_min{0.0};
+  /** Width and height of the covered area. */
+  double size{0.0};
+
+  /** Width and height of one cell. */
+  [[nodiscard]] double tick() const {
+    return size / static_cast<double>(resolution);
+  }
+
+  /** Coordinates sampled for `row` and `column`. */
+  [[nodiscard]] CMyVektor<2> position(std::size_t row,
+                                      std::size_t column) const {
+    return {x_min + static_cast<double>(column) * tick(),
+            y_min + size - static_cast<double>(row) * tick()};
+  }
+
+  /** Returns 'true' if `x` lies inside the covered area. */
+  [[nodiscard]] bool contains(const CMyVektor<2> &x) const {
+    return x[0] >= x_min && x[0] <= x_min + size && x[1] >= y_min &&
+           x[1] <= y_min + size;
+  }
+};
+
+/** Function values on a `resolution` x `resolution` grid. */
+class Heatmap {
+public:
+  Heatmap() = default;
+
+  /**
+   * Allocate an empty grid. Call `Fill()` to compute values.
+   *
+   * @param resolution Grid cells per dimension.
+   * @param x_min Left edge.
+   * @param y_min Bottom edge.
+   * @param size Width and height of the covered area.
+   * @param precision Element type.
+   */
+  Heatmap(std::size_t resolution, double x_min, double y_min, double size,
+          HeatmapPrecision precision);
+
+  /**
+   * Wrap existing values, e.g. loaded from a file.
+   *
+   * @param buffer `resolution * resolution` elements of type `precision`.
+   */
+  Heatmap(std::size_t resolution, double x_min, double y_min, double size,
+          HeatmapPrecision precision, HeapBuffer buffer, double min,
+          double max);
+
+  /** Sample `funktion` at the top left corner of every cell. */
+  void Fill(FunctionPtr<2> funktion);
+
+  /** Sample positions of the heatmap. */
+  [[nodiscard]] const HeatmapGrid &grid() const { return grid_; }
+
+  [[nodiscard]] std::size_t resolution() const { return grid_.resolution; }
+  [[nodiscard]] HeatmapPrecision precision() const { return precision_; }
+  [[nodiscard]] double x_min() const { return grid_.x_min; }
+  [[nodiscard]] double y_min() const { return grid_.y_min; }
+  [[nodiscard]] double size() const { return grid_.size; }
+
+  /** Width and height of one cell. */
+  [[nodiscard]] double tick() const { return grid_.tick(); }
+
+  /** Largest value on the grid. */
+  [[nodiscard]] double max() const { return max_; }
+
+  /** Smallest value on the grid. */
+  [[nodiscard]] double min() const { return min_; }
+
+  /** Raw elements of type `precision()`, row-major, top row first. */
+  [[nodiscard]] const void *data() const { return buffer.data(); }
+  [[nodiscard]] void *data() { return buffer.data(); }
+
+  /** Size of `data()` in bytes. */
+  [[nodiscard]] std::size_t bytes() const {
+    return grid_.resolution * grid_.resolution * element_size(precision_);
+  }
+
+  /** Value at `row` (from the top) and `column`, converted to double. */
+  [[nodiscard]] double at(std::size_t row, std::size_t column) const;
+
+  /** Store `value` at `row` and `column`. Quantizes against the current
+   * `min()`/`max()` for `UNorm16`. */
+  void set(std::size_t row, std::size_t column, double value);
+
+  /** Set the value range, e.g. after loading values from elsewhere. */
+  void set_range(double min, double max) {
+    min_ = min;
+    max_ = max;
+  }
+
+  /** Coordinates sampled for `row` and `column`. */
+  [[nodiscard]] CMyVektor<2> position(std::size_t row,
+                                      std::size_t column) const {
+    return grid_.position(row, column);
+  }
+
+  /** Bilinear estimate of the function and its gradient at a position. */
+  struct Sample {
+    double value{};
+    CMyVektor<2> gradient{};
+  };
+
+  /**
+   * Estimate the function at `x` by bilinear interpolation between the four
+   * surrounding grid samples. The gradient is the derivative of the
+   * interpolant. Positions outside the grid are clamped to its border.
+   */
+  [[nodiscard]] Sample Interpolate(const CMyVektor<2> &x) const;
+
+private:
+  HeatmapGrid grid_{};
+  HeatmapPrecision precision_{HeatmapPrecision::Float64};
+  HeapBuffer buffer{};
+  double max_{-INFINITY};
+  double min_{INFINITY};
+};
+
+#endif // HEATMAP_H_
@@ -0,0 +1,176 @@
+/**
+ * @file heatmap_file.cpp
+ *
+ * @brief Reading, writing and caching heatmap files.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "heatmap_file.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+/** FNV-1a over `size` bytes, continuing from `hash`. */
+auto fnv1a(uint64_t hash, const void *data, std::size_t size) -> uint64_t {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  for (std::size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/** Header describing `heatmap` without its value range. */
+auto describe(std::size_t resolution, double x_min, double y_min, double size,
+              HeatmapPrecision precision, uint64_t fingerprint)
+    -> HeatmapFileHeader {
+  HeatmapFileHeader header{};
+  std::memcpy(header.magic, HEATMAP_MAGIC, sizeof(header.magic));
+  header.precision = static_cast<uint8_t>(precision);
+  header.resolution = resolution;
+  header.x_min = x_min;
+  header.y_min = y_min;
+  header.size = size;
+  header.fingerprint = fingerprint;
+  return header;
+}
+
+/** RAII file descriptor. */
+struct FileDescriptor {
+  int fd{-1};
+  ~FileDescriptor() {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+};
+} // namespace
+
+uint64_t function_fingerprint(FunctionPtr<2> funktion) {
+  /* Irregular points so that symmetric functions are told apart too. */
+  static constexpr double PROBES[][2] = {
+      {0.0, 0.0},       {0.5, -0.25},  {-1.75, 0.375}, {3.125, 2.0625},
+      {-0.8125, -2.25}, {1.0, 1.4375}, {7.5, -5.125},  {-11.0, 13.25},
+  };
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const auto &probe : PROBES) {
+    const double value = funktion(CMyVektor<2>{probe[0], probe[1]});
+    hash = fnv1a(hash, &value, sizeof(value));
+  }
+  return hash;
+}
+
+void SaveHeatmap(const Heatmap &heatmap, uint64_t fingerprint,
+                 const std::string &path) {
+  HeatmapFileHeader header =
+      describe(heatmap.resolution(), heatmap.x_min(), heatmap.y_min(),
+               heatmap.size(), heatmap.precision(), fingerprint);
+  header.min = heatmap.min();
+  header.max = heatmap.max();
+
+  /* Write to a temporary file and rename it, so concurrent readers never
+   * see a partial file. */
+  const std::string tmp = path + ".tmp" + std::to_string(::getpid());
+  std::FILE *file = std::fopen(tmp.c_str(), "wb");
+  if (file == nullptr) {
+    throw std::runtime_error("Could not open heatmap file '" + tmp + "'");
+  }
+  char head[HEATMAP_DATA_OFFSET] = {};
+  std::memcpy(head, &header, sizeof(header));
+  const bool written =
+      std::fwrite(head, 1, sizeof(head), file) == sizeof(head) &&
+      std::fwrite(heatmap.data(), 1, heatmap.bytes(), file) == heatmap.bytes();
+  if (std::fclose(file) != 0 || !written ||
+      std::rename(tmp.c_str(), path.c_str()) != 0) {
+    std::remove(tmp.c_str());
+    throw std::runtime_error("Could not write heatmap file '" + path + "'");
+  }
+}
+
+std::optional<Heatmap> LoadHeatmap(const std::string &path,
+                                   const HeatmapFileHeader &expected) {
+  FileDescriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (file.fd < 0) {
+    return std::nullopt;
+  }
+  HeatmapFileHeader header{};
+  if (::pread(file.fd, &header, sizeof(header), 0) !=
+      static_cast<ssize_t>(sizeof(header))) {
+    return std::nullopt;
+  }
+  if (std::memcmp(header.magic, HEATMAP_MAGIC, sizeof(header.magic)) != 0 ||
+      header.precision != expected.precision ||
+      header.resolution != expected.resolution ||
+      header.x_min != expected.x_min || header.y_min != expected.y_min ||
+      header.size != expected.size ||
+      header.fingerprint != expected.fingerprint) {
+    return std::nullopt;
+  }
+
+  const auto precision = static_cast<HeatmapPrecision>(header.precision);
+  const std::size_t bytes =
+      header.resolution * header.resolution * element_size(precision);
+  struct stat info {};
+  if (::fstat(file.fd, &info) != 0 ||
+      static_cast<std::size_t>(info.st_size) != HEATMAP_DATA_OFFSET + bytes) {
+    return std::nullopt;
+  }
+  return Heatmap(header.resolution, header.x_min, header.y_min, header.size,
+                 precision,
+                 HeapBuffer::MapFile(file.fd, HEATMAP_DATA_OFFSET, bytes),
+                 header.min, header.max);
+}
+
+std::string default_heatmap_cache() {
+  if (const char *xdg = std::getenv("XDG_CACHE_HOME"); xdg && *xdg) {
+    return std::string(xdg) + "/plottings";
+  }
+  if (const char *home = std::getenv("HOME"); home && *home) {
+    return std::string(home) + "/.cache/plottings";
+  }
+  return {};
+}
+
+Heatmap CachedHeatmap(const std::string &cache_dir, std::size_t resolution,
+                      double x_min, double y_min, double size,
+                      HeatmapPrecision precision, FunctionPtr<2> funktion) {
+  if (cache_dir.empty()) {
+    Heatmap ret(resolution, x_min, y_min, size, precision);
+    ret.Fill(funktion);
+    return ret;
+  }
+
+  const HeatmapFileHeader expected =
+      describe(resolution, x_min, y_min, size, precision,
+               function_fingerprint(funktion));
+  /* The name identifies the grid. The header check guards against stale or
+   * colliding files. */
+  const uint64_t key =
+      fnv1a(0xcbf29ce484222325ULL, &expected, sizeof(expected));
+  char name[32];
+  std::snprintf(name, sizeof(name), "heatmap-%016llx.bin",
+                static_cast<unsigned long long>(key));
+  const std::string path = cache_dir + "/" + name;
+
+  if (auto cached = LoadHeatmap(path, expected)) {
+    return std::move(*cached);
+  }
+
+  Heatmap ret(resolution, x_min, y_min, size, precision);
+  ret.Fill(funktion);
+  try {
+    std::filesystem::create_directories(cache_dir);
+    SaveHeatmap(ret, expected.fingerprint, path);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "Heatmap cache not written: %s\n", e.what());
+  }
+  return ret;
+}
@@ -0,0 +1,90 @@
+#ifndef HEATMAP_FILE_H_
+#define HEATMAP_FILE_H_
+/**
+ * @file heatmap_file.hpp
+ *
+ * @brief Binary heatmap file format and on-disk heatmap cache.
+ *
+ * A file is a `HeatmapFileHeader` followed by the raw grid elements at
+ * `HEATMAP_DATA_OFFSET`, exactly as they are held in memory. Loading maps
+ * the file instead of parsing it, so even large grids are available
+ * immediately and pages are read only when they are drawn.
+ *
+ * The header records bounds, resolution, element type and a fingerprint of
+ * the sampled function. A cached grid is only used if all of them match the
+ * requested heatmap. Values are stored in host byte order.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "heatmap.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/** First bytes of every heatmap file. */
+static constexpr char HEATMAP_MAGIC[8] = {'P', 'L', 'T', 'H',
+                                          'E', 'A', 'T', '1'};
+
+/** Offset of the grid data. Keeps the data cache-line aligned. */
+static constexpr std::size_t HEATMAP_DATA_OFFSET = 128;
+
+/** Header of a heatmap file. */
+struct HeatmapFileHeader {
+  char magic[8]{};
+  uint8_t precision{};
+  uint8_t reserved[7]{};
+  uint64_t resolution{};
+  double x_min{};
+  double y_min{};
+  double size{};
+  /** Value range of the grid. */
+  double min{};
+  double max{};
+  /** `function_fingerprint()` of the sampled function. */
+  uint64_t fingerprint{};
+};
+static_assert(sizeof(HeatmapFileHeader) <= HEATMAP_DATA_OFFSET);
+
+/**
+ * Fingerprint of `funktion`, derived from its values at a few fixed points.
+ *
+ * Function addresses change between builds and runs, values do not. Two
+ * functions with the same fingerprint agree at all probe points, which in
+ * practice means they are the same function.
+ */
+[[nodiscard]] uint64_t function_fingerprint(FunctionPtr<2> funktion);
+
+/** Write `heatmap` to `path`. Throws `std::runtime_error` on failure. */
+void SaveHeatmap(const Heatmap &heatmap, uint64_t fingerprint,
+                 const std::string &path);
+
+/**
+ * Map the heatmap file at `path`.
+ *
+ * @returns The heatmap, or nothing if the file does not exist, is malformed
+ * or does not match the bounds, resolution, precision and fingerprint of
+ * `expected`.
+ */
+[[nodiscard]] std::optional<Heatmap>
+LoadHeatmap(const std::string &path, const HeatmapFileHeader &expected);
+
+/**
+ * Default cache directory: `$XDG_CACHE_HOME/plottings` or
+ * `$HOME/.cache/plottings`. Empty if neither variable is set.
+ */
+[[nodiscard]] std::string default_heatmap_cache();
+
+/**
+ * Load the matching heatmap from `cache_dir` or compute and store it there.
+ *
+ * An empty `cache_dir` disables the cache. Failing to write the cache is
+ * not an error, the computed heatmap is returned regardless.
+ */
+[[nodiscard]] Heatmap CachedHeatmap(const std::string &cache_dir,
+                                    std::size_t resolution, double x_min,
+                                    double y_min, double size,
+                                    HeatmapPrecision precision,
+                                    FunctionPtr<2> funktion);
+
+#endif // HEATMAP_FILE_H_
@@ -0,0 +1,70 @@
+/**
+ * @file input_log.cpp
+ *
+ * @brief Reading and writing input logs.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "input_log.hpp"
+
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+/** Names of `InputKind` values in the log file, in declaration order. */
+constexpr std::array<std::string_view, 6> KIND_NAMES = {
+    "start_x", "start_y", "max_iterations", "iteration", "start", "reset",
+};
+
+auto kind_name(InputKind kind) -> std::string_view {
+  return KIND_NAMES.at(static_cast<std::size_t>(kind));
+}
+
+auto kind_from_name(std::string_view name) -> InputKind {
+  for (std::size_t i = 0; i < KIND_NAMES.size(); i++) {
+    if (KIND_NAMES[i] == name) {
+      return static_cast<InputKind>(i);
+    }
+  }
+  throw std::runtime_error("Unknown input event '" + std::string(name) + "'");
+}
+} // namespace
+
+void InputLog::Save(const std::string &path) const {
+  std::ofstream file(path);
+  if (!file) {
+    throw std::runtime_error("Could not open input log '" + path + "'");
+  }
+  /* Doubles must survive the round trip for the replay to be exact. */
+  file << std::setprecision(std::numeric_limits<double>::max_digits10);
+  for (const auto &event : events) {
+    file << event.time << ' ' << kind_name(event.kind) << ' ' << event.value
+         << '\n';
+  }
+  if (!file) {
+    throw std::runtime_error("Could not write input log '" + path + "'");
+  }
+}
+
+InputLog InputLog::Load(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Could not open input log '" + path + "'");
+  }
+  InputLog ret{};
+  InputEvent event{};
+  std::string kind;
+  while (file >> event.time >> kind >> event.value) {
+    event.kind = kind_from_name(kind);
+    ret.events.push_back(event);
+  }
+  if (!file.eof()) {
+    throw std::runtime_error("Malformed input log '" + path + "'");
+  }
+  return ret;
+}
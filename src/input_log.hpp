@@ -0,0 +1,64 @@
+#ifndef INPUT_LOG_H_
+#define INPUT_LOG_H_
+/**
+ * @file input_log.hpp
+ *
+ * @brief Recorded user input of the UI.
+ *
+ * Every input that changes the calculation (drags, slider, buttons) is
+ * turned into an `InputEvent`. The same events drive the live UI and the
+ * headless replay, so a recorded session can be replayed deterministically
+ * without a window.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Kind of user input. */
+enum class InputKind : uint8_t {
+  /** "Start x" was dragged. `value` is the new x coordinate. */
+  StartX,
+  /** "Start y" was dragged. `value` is the new y coordinate. */
+  StartY,
+  /** "Max iterations" was dragged. `value` is the new limit. */
+  MaxIterations,
+  /** "Iteration step" slider was moved. `value` is the new position. */
+  Iteration,
+  /** "Start Calculation" was clicked. */
+  StartCalculation,
+  /** "Reset" was clicked. */
+  Reset,
+};
+
+/** One user input with the time it happened at. */
+struct InputEvent {
+  /** Seconds since the recording started. */
+  double time{};
+
+  /** What happened. */
+  InputKind kind{};
+
+  /** New value for drags and sliders. Unused for buttons. */
+  double value{};
+};
+
+/**
+ * Chronological list of input events.
+ *
+ * Stored as a text file with one event per line: `<time> <kind> <value>`.
+ */
+struct InputLog {
+  /** Events sorted by time. */
+  std::vector<InputEvent> events{};
+
+  /** Write the log to `path`. Throws `std::runtime_error` on failure. */
+  void Save(const std::string &path) const;
+
+  /** Read a log from `path`. Throws `std::runtime_error` on failure. */
+  [[nodiscard]] static InputLog Load(const std::string &path);
+};
+
+#endif // INPUT_LOG_H_
@@ -14,6 +14,7 @@
  * @author Johannes Schiffer
  * @date 03-05-2024
  */
+#include "alloc_counter.hpp"
 #include "cmyvektor.hpp"
 #include <cstddef>
 template <std::size_t N> using FunctionPtr = double (*)(const CMyVektor<N> &x);
@@ -39,7 +40,8 @@ template <std::size_t N> struct Point {
    * @param funktion N-dimensional function that maps the vector to a value.
    */
   constexpr Point(CMyVektor<N> vector, FunctionPtr<N> funktion)
-      : vector(vector), value(funktion(vector)){};
+      : vector(vector),
+        value(evaluate(funktion, vector, eval_profile::Site::Point)){};
 
   /* default constructor */
   constexpr Point() = default;
@@ -128,6 +130,11 @@ template <std::size_t N> struct IterationData {
     return use_next() && (test.value > next.value);
   }
 
+  /** Objective evaluations per `AtPoint` (and thus per `Next`): the current
+   * point, two per dimension for the gradient, the next and the test
+   * point. */
+  static constexpr std::size_t EVALUATIONS_PER_ITERATION = 2 * N + 3;
+
   /** Maximum number of iteration steps. */
   static constexpr std::size_t MAX_ITERATIONS = 25;
 
@@ -138,7 +145,14 @@ template <std::size_t N> struct IterationData {
   /** Returns 'true' if the optimum has been found. It is then the 'current'
    * iteration. */
   [[nodiscard]] inline constexpr auto done() const -> bool {
-    return index == MAX_ITERATIONS || current_grad.norm() < GRAD_LIMIT;
+    return done(MAX_ITERATIONS);
+  }
+
+  /** Same as `done()` but with a custom iteration limit, e.g. for long runs
+   * that are recorded in a `Trajectory`. */
+  [[nodiscard]] inline constexpr auto done(std::size_t max_iterations) const
+      -> bool {
+    return index >= max_iterations || current_grad.norm() < GRAD_LIMIT;
   }
   /* Move constructor. */
   constexpr IterationData(const IterationData &&other)
@@ -153,7 +167,7 @@ template <std::size_t N> struct IterationData {
         index(other.index), current(other.current),
         current_grad(other.current_grad), next(other.next), test(other.test) {}
   /* Copy assignment operator. */
-  IterationData<N> &operator=(IterationData<N> &other);
+  IterationData<N> &operator=(const IterationData<N> &other);
 
 private:
   /**
@@ -175,7 +189,7 @@ IterationData<N> &IterationData<N>::operator=(IterationData<N> &&other) {
   return *this;
 }
 template <std::size_t N>
-IterationData<N> &IterationData<N>::operator=(IterationData<N> &other) {
+IterationData<N> &IterationData<N>::operator=(const IterationData<N> &other) {
   this->funktion = other.funktion;
   this->step_size = other.step_size;
   this->index = other.index;
@@ -212,6 +226,7 @@ IterationData<N> IterationData<N>::AtPoint(const CMyVektor<N> &current_point,
 
 template <std::size_t N>
 IterationData<N> IterationData<N>::Next(const IterationData &previous) {
+  TRACE_SCOPE("IterationData::Next");
   double next_step_size;
   CMyVektor<N> next_vector;
   /* For rules see exercise. First test next step size. If result is not
@@ -246,17 +261,24 @@ std::ostream &operator<<(std::ostream &stream, const IterationData<N> &x) {
   return stream;
 }
 
-/** Task 3. Maximize `funktion` by numeric gradient descent. */
-template <std::size_t N>
+/**
+ * Task 3. Maximize `funktion` by numeric gradient descent.
+ *
+ * Every iteration is passed to `log`, e.g. an `IterationWriter` (see
+ * writer.hpp).
+ */
+template <std::size_t N, typename Log>
 CMyVektor<N> gradient_descent(const CMyVektor<N> &start_point,
-                              FunctionPtr<N> funktion,
-                              double start_step_size = 1.0) {
+                              FunctionPtr<N> funktion, double start_step_size,
+                              Log &&log) {
 
   /* initialize current iteration data */
   auto iteration =
       IterationData<N>::AtPoint(start_point, funktion, start_step_size, 0);
   for (std::size_t _it = 0; _it < IterationData<N>::MAX_ITERATIONS; _it++) {
-    std::cout << iteration << std::endl;
+    log(iteration);
+    /* Logging may allocate, the step itself must not. */
+    ALLOC_FREE_SCOPE("gradient_descent step");
     if (iteration.done()) {
       return iteration.current.vector;
     }
@@ -264,4 +286,16 @@ CMyVektor<N> gradient_descent(const CMyVektor<N> &start_point,
   }
   return iteration.current.vector;
 }
+
+/** Task 3. Maximize `funktion` by numeric gradient descent and print every
+ * iteration. */
+template <std::size_t N>
+CMyVektor<N> gradient_descent(const CMyVektor<N> &start_point,
+                              FunctionPtr<N> funktion,
+                              double start_step_size = 1.0) {
+  return gradient_descent<N>(start_point, funktion, start_step_size,
+                             [](const IterationData<N> &iteration) {
+                               std::cout << iteration << std::endl;
+                             });
+}
 #endif // ITERATION_H_
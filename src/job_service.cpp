@@ -0,0 +1,117 @@
+/**
+ * @file job_service.cpp
+ *
+ * @brief Implementation of the coalescing job service.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "job_service.hpp"
+#include "batch.hpp"
+#include "functions.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+JobService::JobService(std::size_t threads)
+    : pool(threads), dispatcher(&JobService::dispatch, this) {}
+
+JobService::~JobService() {
+  {
+    const std::lock_guard lock(mutex);
+    stop = true;
+    pending.clear();
+  }
+  wake.notify_all();
+  dispatcher.join();
+}
+
+void JobService::Submit(const protocol::Optimize &request,
+                        const uint8_t *starts, Done done) {
+  protocol::CheckOptions(request.objective, request.step_size,
+                         request.max_iterations);
+  auto job = std::make_shared<Job>();
+  job->request = request;
+  job->dim = protocol::dimension(request.objective);
+  job->starts.resize(request.count * job->dim);
+  std::memcpy(job->starts.data(), starts,
+              job->starts.size() * sizeof(double));
+  job->payload.resize(sizeof(protocol::Results) +
+                      request.count * protocol::result_size(job->dim));
+  const protocol::Results header{request.job_id,
+                                 static_cast<uint32_t>(job->dim), 0,
+                                 request.count};
+  std::memcpy(job->payload.data(), &header, sizeof(header));
+  job->remaining = request.count;
+  job->done = std::move(done);
+  if (request.count == 0) {
+    job->done(std::move(job->payload));
+    return;
+  }
+
+  bool batch_ready = false;
+  {
+    const std::lock_guard lock(mutex);
+    const bool was_empty = pending.empty();
+    for (std::size_t i = 0; i < request.count; i++) {
+      pending.push_back(Item{job, i});
+    }
+    batch_ready = was_empty || pending.size() >= BATCH_SIZE;
+  }
+  if (batch_ready) {
+    wake.notify_one();
+  }
+}
+
+void JobService::dispatch() {
+  std::unique_lock lock(mutex);
+  while (true) {
+    wake.wait(lock, [this] { return stop || !pending.empty(); });
+    /* Give concurrent small requests a moment to join the batch. */
+    wake.wait_for(lock, COALESCE_WINDOW,
+                  [this] { return stop || pending.size() >= BATCH_SIZE; });
+    if (stop) {
+      return;
+    }
+    while (!pending.empty()) {
+      const std::size_t size = std::min(BATCH_SIZE, pending.size());
+      std::vector<Item> batch(std::make_move_iterator(pending.begin()),
+                              std::make_move_iterator(pending.begin() + size));
+      pending.erase(pending.begin(), pending.begin() + size);
+      lock.unlock();
+      pool.Submit([batch = std::move(batch)] {
+        for (const Item &item : batch) {
+          run(item);
+        }
+      });
+      lock.lock();
+    }
+  }
+}
+
+void JobService::run(const Item &item) {
+  Job &job = *item.job;
+  const protocol::Optimize &request = job.request;
+  const double *start = job.starts.data() + item.index * job.dim;
+  uint8_t *slot = job.payload.data() + sizeof(protocol::Results) +
+                  item.index * protocol::result_size(job.dim);
+  const auto solve = [&]<std::size_t N>(FunctionPtr<N> funktion) {
+    CMyVektor<N> x{};
+    std::copy(start, start + N, x.begin());
+    const RunResult<N> result = Optimize<N>(x, funktion, request.step_size,
+                                            request.max_iterations);
+    protocol::EncodeResult<N>(result.end, result.gradient_norm,
+                              result.iterations, result.converged, slot);
+  };
+  if (request.objective == protocol::Objective::F) {
+    solve.template operator()<2>(functions::f);
+  } else {
+    solve.template operator()<3>(functions::g);
+  }
+
+  if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    job.done(std::move(job.payload));
+  }
+}
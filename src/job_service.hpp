@@ -0,0 +1,97 @@
+#ifndef JOB_SERVICE_H_
+#define JOB_SERVICE_H_
+/**
+ * @file job_service.hpp
+ *
+ * @brief Coalescing execution of small optimization jobs for the compute
+ * server.
+ *
+ * Every start point of a submitted job becomes one item in a shared queue.
+ * A dispatcher thread takes up to `BATCH_SIZE` items at a time, from any
+ * number of jobs and connections, and runs them as one task on a long-lived
+ * `ThreadPool`. When the queue holds less than a full batch, the dispatcher
+ * waits up to `COALESCE_WINDOW` for more, so thousands of one-point requests
+ * per second cost a few hundred pool tasks instead of one each. The pool,
+ * and with it the objectives' code and data, stays warm between requests.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "protocol.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Runs `protocol::Optimize` jobs in coalesced batches. */
+class JobService {
+public:
+  /** Most start points run in one pool task. */
+  static constexpr std::size_t BATCH_SIZE = 64;
+
+  /** Longest wait for more items before running a partial batch. */
+  static constexpr std::chrono::microseconds COALESCE_WINDOW{200};
+
+  /** Receives the complete `Results` payload, header included. Called on a
+   * worker thread. */
+  using Done = std::function<void(std::vector<uint8_t> &&payload)>;
+
+  /** Start `threads` workers, zero means one per hardware thread. */
+  explicit JobService(std::size_t threads = 0);
+
+  /** Drops queued items and waits for running batches. */
+  ~JobService();
+
+  JobService(const JobService &) = delete;
+  JobService &operator=(const JobService &) = delete;
+
+  /**
+   * Queue `job`. `starts` holds `job.count` start points as sent on the
+   * wire, no alignment needed. Throws `std::runtime_error` if the
+   * options fail `protocol::CheckOptions`.
+   * Jobs without start points are answered right away.
+   */
+  void Submit(const protocol::Optimize &job, const uint8_t *starts, Done done);
+
+private:
+  struct Job {
+    protocol::Optimize request{};
+    std::size_t dim{};
+    std::vector<double> starts{};
+    /** `Results` header followed by one slot per start point. Items write
+     * disjoint slots, so no lock is needed. */
+    std::vector<uint8_t> payload{};
+    std::atomic<std::size_t> remaining{0};
+    Done done{};
+  };
+
+  struct Item {
+    std::shared_ptr<Job> job;
+    std::size_t index;
+  };
+
+  std::mutex mutex{};
+  std::condition_variable wake{};
+  /** Protected by `mutex`. */
+  std::deque<Item> pending{};
+  bool stop{false};
+
+  ThreadPool pool;
+  /** Started last, stopped first. */
+  std::thread dispatcher;
+
+  void dispatch();
+
+  /** Optimize from the start point of `item` and store its result. */
+  static void run(const Item &item);
+};
+
+#endif // JOB_SERVICE_H_
@@ -0,0 +1,352 @@
+/**
+ * @file macro_bench.cpp
+ *
+ * @brief End-to-end benchmark of the optimizers on the test function corpus.
+ *
+ * Every optimizer runs from `POINTS` fixed random start points on every
+ * function of corpus.hpp, in several dimensions and with several thread
+ * counts, through the same `RunBatch` path as the headless mode. Per case it
+ * records the wall time (best of `REPEATS`), the objective evaluations, the
+ * iterations and the mean distance of the final value to the optimum. The
+ * evaluations are counted by wrapping the objective, so they stay right if
+ * an optimizer evaluates more or less than one stencil per iteration.
+ *
+ * Usage: `plottings-macrobench [--filter <text>] [--max-iterations <n>]
+ * [--baseline <file>] [--write-baseline <file>] [--threshold <fraction>]`.
+ * With `--baseline` every metric is compared to the stored one and the exit
+ * code is 1 if any got worse by more than the threshold. Usage errors exit
+ * with 2, other failures with 3.
+ *
+ * The baseline is a text file with one line per case: name, wall time in
+ * seconds, evaluations, iterations and accuracy, separated by blanks. Lines
+ * starting with '#' are comments.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "batch.hpp"
+#include "corpus.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+/** Start points per case. */
+constexpr std::size_t POINTS = 1024;
+
+/** Timed repetitions per case, the fastest counts. */
+constexpr int REPEATS = 3;
+
+constexpr std::size_t THREAD_COUNTS[] = {1, 2, 4};
+
+constexpr double STEP_SIZE = 1.0;
+constexpr std::size_t DEFAULT_MAX_ITERATIONS = 500;
+constexpr double DEFAULT_THRESHOLD = 0.1;
+
+/** Differences below these are noise, not regressions. Short cases are
+ * dominated by thread start-up and scheduling. */
+constexpr double SECONDS_TOLERANCE = 2e-3;
+constexpr double ACCURACY_TOLERANCE = 1e-9;
+
+/** Measurements of one case. */
+struct CaseResult {
+  std::string name{};
+  double seconds{};
+  double evaluations{};
+  double iterations{};
+  /** Mean |optimum - final value| over the start points. */
+  double accuracy{};
+};
+
+struct Options {
+  std::string filter{};
+  std::size_t max_iterations{DEFAULT_MAX_ITERATIONS};
+  std::string baseline{};
+  std::string write_baseline{};
+  double threshold{DEFAULT_THRESHOLD};
+};
+
+/** Objective and evaluation count of the run on this thread. Every worker
+ * counts into its own copy, so counting needs no synchronization. */
+template <std::size_t N>
+thread_local FunctionPtr<N> counted_funktion = nullptr;
+template <std::size_t N> thread_local std::size_t counted_evaluations = 0;
+
+/** Optimizer of the case being run, set before its batch starts. */
+template <std::size_t N> OptimizerPtr<N> counted_optimizer = nullptr;
+
+template <std::size_t N> double counted(const CMyVektor<N> &x) {
+  counted_evaluations<N>++;
+  return counted_funktion<N>(x);
+}
+
+/** `counted_optimizer` on `funktion`, with the evaluations it made. */
+template <std::size_t N>
+RunResult<N> counted_optimize(const CMyVektor<N> &start,
+                              FunctionPtr<N> funktion, double step_size,
+                              std::size_t max_iterations) {
+  counted_funktion<N> = funktion;
+  counted_evaluations<N> = 0;
+  RunResult<N> result =
+      counted_optimizer<N>(start, counted<N>, step_size, max_iterations);
+  result.evaluations = counted_evaluations<N>;
+  return result;
+}
+
+/** Deterministic start points in the box of `problem`. */
+template <std::size_t N>
+std::vector<CMyVektor<N>> start_points(const corpus::Problem<N> &problem) {
+  std::mt19937_64 random(N * 1000003 + std::string_view(problem.name).size());
+  std::uniform_real_distribution<double> coordinate(problem.lower,
+                                                    problem.upper);
+  std::vector<CMyVektor<N>> points(POINTS);
+  for (auto &point : points) {
+    for (double &e : point) {
+      e = coordinate(random);
+    }
+  }
+  return points;
+}
+
+template <std::size_t N>
+CaseResult run_case(const std::string &name, OptimizerPtr<N> optimize,
+                    const corpus::Problem<N> &problem,
+                    const std::vector<CMyVektor<N>> &points,
+                    std::size_t threads, std::size_t max_iterations) {
+  using Clock = std::chrono::steady_clock;
+  CaseResult result{};
+  result.name = name;
+  result.seconds = std::numeric_limits<double>::infinity();
+
+  for (int repeat = 0; repeat < REPEATS; repeat++) {
+    double evaluations = 0.0;
+    double iterations = 0.0;
+    double error = 0.0;
+    std::size_t read = 0;
+    const auto next = [&](CMyVektor<N> &start) {
+      if (read == points.size()) {
+        return false;
+      }
+      start = points[read++];
+      return true;
+    };
+    const auto write = [&](const RunResult<N> &run) {
+      evaluations += static_cast<double>(run.evaluations);
+      iterations += static_cast<double>(run.iterations);
+      error += std::abs(problem.optimum - run.end.value);
+    };
+
+    /* Starting the workers is part of an end-to-end run. */
+    const auto start = Clock::now();
+    {
+      counted_optimizer<N> = optimize;
+      ThreadPool pool(threads);
+      RunBatch<N>(pool, threads * 16, next, counted_optimize<N>,
+                  problem.funktion, STEP_SIZE, max_iterations, write);
+    }
+    const double seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    result.seconds = std::min(result.seconds, seconds);
+    result.evaluations = evaluations;
+    result.iterations = iterations;
+    result.accuracy = error / static_cast<double>(points.size());
+  }
+  return result;
+}
+
+template <std::size_t N>
+void run_dimension(const Options &options, std::vector<CaseResult> &results) {
+  for (const auto &problem : corpus::PROBLEMS<N>) {
+    const auto points = start_points(problem);
+    for (const auto &optimizer : OPTIMIZERS<N>) {
+      for (const std::size_t threads : THREAD_COUNTS) {
+        const std::string name = std::string(optimizer.name) + "/" +
+                                 problem.name + "/N=" + std::to_string(N) +
+                                 "/threads=" + std::to_string(threads);
+        if (name.find(options.filter) == std::string::npos) {
+          continue;
+        }
+        results.push_back(run_case<N>(name, optimizer.optimize, problem,
+                                      points, threads,
+                                      options.max_iterations));
+        const CaseResult &result = results.back();
+        std::printf("%-44s %10.4f %14.0f %12.0f %12.4g\n", name.c_str(),
+                    result.seconds, result.evaluations, result.iterations,
+                    result.accuracy);
+        std::fflush(stdout);
+      }
+    }
+  }
+}
+
+std::map<std::string, CaseResult> read_baseline(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error("Could not open baseline '" + path + "'");
+  }
+  std::map<std::string, CaseResult> baseline;
+  std::string line;
+  for (std::size_t number = 1; std::getline(file, line); number++) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    CaseResult result{};
+    if (!(fields >> result.name >> result.seconds >> result.evaluations >>
+          result.iterations >> result.accuracy)) {
+      throw std::runtime_error("Malformed baseline line " +
+                               std::to_string(number) + " in '" + path + "'");
+    }
+    baseline[result.name] = result;
+  }
+  return baseline;
+}
+
+void write_baseline(const std::string &path,
+                    const std::vector<CaseResult> &results) {
+  const std::unique_ptr<std::FILE, decltype(&std::fclose)> file(
+      std::fopen(path.c_str(), "w"), &std::fclose);
+  if (!file) {
+    throw std::runtime_error("Could not open '" + path + "' for writing");
+  }
+  std::fprintf(file.get(), "# name seconds evaluations iterations accuracy\n");
+  for (const auto &result : results) {
+    std::fprintf(file.get(), "%s %.17g %.17g %.17g %.17g\n",
+                 result.name.c_str(), result.seconds, result.evaluations,
+                 result.iterations, result.accuracy);
+  }
+  if (std::ferror(file.get()) != 0) {
+    throw std::runtime_error("Could not write '" + path + "'");
+  }
+}
+
+/**
+ * Print every metric that is worse than in `baseline` by more than
+ * `threshold` as a fraction of the baseline.
+ *
+ * @returns Number of regressions.
+ */
+std::size_t compare(const std::vector<CaseResult> &results,
+                    const std::map<std::string, CaseResult> &baseline,
+                    double threshold) {
+  std::size_t regressions = 0;
+  const auto check = [&](const std::string &name, const char *metric,
+                         double current, double base, double tolerance) {
+    const double limit = base * (1.0 + threshold) + tolerance;
+    if (current > limit) {
+      std::printf("REGRESSION %s %s: %.6g -> %.6g (%+.1f%%)\n", name.c_str(),
+                  metric, base, current,
+                  base > 0.0 ? (current / base - 1.0) * 100.0 : 100.0);
+      regressions++;
+    }
+  };
+  for (const auto &result : results) {
+    const auto found = baseline.find(result.name);
+    if (found == baseline.end()) {
+      std::printf("new        %s: not in the baseline\n", result.name.c_str());
+      continue;
+    }
+    const CaseResult &base = found->second;
+    check(result.name, "seconds", result.seconds, base.seconds,
+          SECONDS_TOLERANCE);
+    check(result.name, "evaluations", result.evaluations, base.evaluations,
+          0.0);
+    check(result.name, "iterations", result.iterations, base.iterations, 0.0);
+    check(result.name, "accuracy", result.accuracy, base.accuracy,
+          ACCURACY_TOLERANCE);
+  }
+  return regressions;
+}
+
+Options parse_options(int argc, char **argv) {
+  Options options{};
+  for (int i = 1; i < argc; i += 2) {
+    const std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      throw std::invalid_argument("Missing value for '" + std::string(arg) +
+                                  "'");
+    }
+    const std::string value = argv[i + 1];
+    const auto number = [&](auto parse) {
+      try {
+        return parse(value);
+      } catch (const std::logic_error &) {
+        throw std::invalid_argument("Invalid value '" + value + "' for '" +
+                                    std::string(arg) + "'");
+      }
+    };
+    if (arg == "--filter") {
+      options.filter = value;
+    } else if (arg == "--max-iterations") {
+      options.max_iterations =
+          number([](const std::string &text) { return std::stoul(text); });
+    } else if (arg == "--baseline") {
+      options.baseline = value;
+    } else if (arg == "--write-baseline") {
+      options.write_baseline = value;
+    } else if (arg == "--threshold") {
+      options.threshold =
+          number([](const std::string &text) { return std::stod(text); });
+      if (!(options.threshold >= 0.0)) {
+        throw std::invalid_argument("The threshold must not be negative");
+      }
+    } else {
+      throw std::invalid_argument("Unknown argument '" + std::string(arg) +
+                                  "'");
+    }
+  }
+  return options;
+}
+} // namespace
+
+auto main(int argc, char **argv) -> int {
+  Options options{};
+  try {
+    options = parse_options(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 2;
+  }
+
+  try {
+    std::vector<CaseResult> results;
+    std::printf("%-44s %10s %14s %12s %12s\n", "case", "seconds",
+                "evaluations", "iterations", "accuracy");
+    run_dimension<2>(options, results);
+    run_dimension<4>(options, results);
+    run_dimension<8>(options, results);
+
+    if (!options.write_baseline.empty()) {
+      write_baseline(options.write_baseline, results);
+    }
+    if (!options.baseline.empty()) {
+      const std::size_t regressions =
+          compare(results, read_baseline(options.baseline), options.threshold);
+      std::printf("%zu regression(s) beyond %.1f%%\n", regressions,
+                  options.threshold * 100.0);
+      if (regressions > 0) {
+        return 1;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 3;
+  }
+  return 0;
+}
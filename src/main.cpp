@@ -10,32 +10,218 @@
 #include <imgui_impl_glfw.h>
 #define GL_SILENCE_DEPRECATION
 #include "functions.hpp"
+#include "headless.hpp"
+#include "heatmap_file.hpp"
 #include "iteration.hpp"
+#include "replay.hpp"
+#include "trace.hpp"
 #include "ui.hpp"
+#include "writer.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
 
-auto main() -> int {
+namespace {
+/** Run a task from `start` and write its iterations to `path`. The last
+ * iteration holds the result. */
+template <std::size_t N>
+void log_task(const std::string &path, const CMyVektor<N> &start,
+              FunctionPtr<N> funktion, double step_size, OutputFormat format) {
+  const std::unique_ptr<std::FILE, decltype(&std::fclose)> file(
+      std::fopen(path.c_str(), "w"), &std::fclose);
+  if (!file) {
+    throw std::runtime_error("Could not open '" + path + "'");
+  }
+  OutputBuffer out(file.get());
+  gradient_descent<N>(start, funktion, step_size,
+                      IterationWriter<N>(out, format));
+  out.Flush();
+}
+} // namespace
+
+auto main(int argc, char **argv) -> int {
+  TRACE_THREAD_NAME("main");
+
+  /* Command line mode, see headless.hpp. Dispatched before anything else so
+   * it starts fast and never touches GLFW. */
+  if (argc > 1 && std::string_view(argv[1]) == "--headless") {
+    return RunHeadless(argc - 2, argv + 2);
+  }
+
+  /* Optional input recording, headless replay and compute server:
+   *
+   *   plottings --record <log>                  record input while using the UI
+   *   plottings --replay <log> [--report <json>] replay without window
+   *   plottings --connect <endpoint> [--attach <run>] calculate on the server
+   *   plottings --heatmap-resolution <n> --heatmap-precision <f64|f32|u16>
+   *             --heatmap-cache <dir|none>
+   *   plottings --export-heatmap <file>          write heatmap without window
+   *   plottings --headless ...                   optimize without window
+   *   plottings --log-format <csv|jsonl|binary> --log-output <prefix>
+   *             write the task iterations to <prefix>-f.<ext>, <prefix>-g.<ext>
+   */
+  const char *record_path = nullptr;
+  const char *replay_path = nullptr;
+  const char *report_path = nullptr;
+  const char *connect_endpoint = nullptr;
+  std::optional<uint32_t> attach_run{};
+  std::size_t heatmap_resolution = 64;
+  HeatmapPrecision heatmap_precision = HeatmapPrecision::Float32;
+  std::string heatmap_cache = default_heatmap_cache();
+  const char *export_path = nullptr;
+  OutputFormat log_format = OutputFormat::Text;
+  std::string_view log_format_name = "text";
+  const char *log_prefix = nullptr;
+  for (int i = 1; i < argc; i += 2) {
+    const std::string_view arg = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for '" << arg << "'" << std::endl;
+      return 1;
+    }
+    if (arg == "--record") {
+      record_path = argv[i + 1];
+    } else if (arg == "--replay") {
+      replay_path = argv[i + 1];
+    } else if (arg == "--report") {
+      report_path = argv[i + 1];
+    } else if (arg == "--connect") {
+      connect_endpoint = argv[i + 1];
+    } else if (arg == "--attach") {
+      const std::string_view value = argv[i + 1];
+      uint32_t run_id = 0;
+      const auto [end, error] =
+          std::from_chars(value.data(), value.data() + value.size(), run_id);
+      if (error != std::errc() || end != value.data() + value.size()) {
+        std::cerr << "Invalid run id '" << value << "'" << std::endl;
+        return 1;
+      }
+      attach_run = run_id;
+    } else if (arg == "--heatmap-resolution") {
+      const std::string_view value = argv[i + 1];
+      const auto [end, error] = std::from_chars(
+          value.data(), value.data() + value.size(), heatmap_resolution);
+      if (error != std::errc() || end != value.data() + value.size() ||
+          heatmap_resolution == 0) {
+        std::cerr << "Invalid heatmap resolution '" << value << "'"
+                  << std::endl;
+        return 1;
+      }
+    } else if (arg == "--heatmap-precision") {
+      try {
+        heatmap_precision = parse_precision(argv[i + 1]);
+      } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+      }
+    } else if (arg == "--heatmap-cache") {
+      heatmap_cache =
+          argv[i + 1] == std::string_view("none") ? "" : argv[i + 1];
+    } else if (arg == "--export-heatmap") {
+      export_path = argv[i + 1];
+    } else if (arg == "--log-format") {
+      try {
+        log_format = parse_output_format(argv[i + 1]);
+      } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+      }
+      log_format_name = argv[i + 1];
+    } else if (arg == "--log-output") {
+      log_prefix = argv[i + 1];
+    } else {
+      std::cerr << "Unknown argument '" << arg << "'" << std::endl;
+      return 1;
+    }
+  }
+
+  if (replay_path != nullptr) {
+    try {
+      const FrameStats stats = Replay(InputLog::Load(replay_path));
+      std::printf("frames %zu, events %zu, mean %.3f us, p50 %.3f us, p95 "
+                  "%.3f us, p99 %.3f us, max %.3f us\n",
+                  stats.frames, stats.events, stats.mean * 1e6,
+                  stats.p50 * 1e6, stats.p95 * 1e6, stats.p99 * 1e6,
+                  stats.max * 1e6);
+      if (report_path != nullptr) {
+        stats.WriteReport(report_path);
+      }
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  if (export_path != nullptr) {
+    const Heatmap heatmap = CachedHeatmap(
+        heatmap_cache, heatmap_resolution, GuiHandle::START[0],
+        GuiHandle::START[1], GuiHandle::HEATMAP_SIZE, heatmap_precision,
+        functions::f);
+    SaveHeatmap(heatmap, function_fingerprint(functions::f), export_path);
+    return 0;
+  }
 
   /* Calculate results from tasks. */
   static constexpr CMyVektor<2> START_F{0.2, -2.1};
-  const CMyVektor<2> result_f = gradient_descent<2>(START_F, functions::f);
-  std::cout << result_f << std::endl;
-
   static constexpr double INIT_STEP_SIZE_G = 0.1;
   static constexpr CMyVektor<3> START_G{0.0, 0.0, 0.0};
-  const CMyVektor<3> result_g =
-      gradient_descent<3>(START_G, functions::g, INIT_STEP_SIZE_G);
-  std::cout << result_g << std::endl;
+  if (log_format == OutputFormat::Text) {
+    const CMyVektor<2> result_f = gradient_descent<2>(START_F, functions::f);
+    std::cout << result_f << std::endl;
+
+    const CMyVektor<3> result_g =
+        gradient_descent<3>(START_G, functions::g, INIT_STEP_SIZE_G);
+    std::cout << result_g << std::endl;
+  } else {
+    /* The tasks differ in dimension and thus in header, so each gets its
+     * own file. */
+    if (log_prefix == nullptr) {
+      std::cerr << "--log-format " << log_format_name
+                << " needs --log-output <prefix>" << std::endl;
+      return 1;
+    }
+    const std::string extension(
+        log_format == OutputFormat::Binary ? "bin" : log_format_name);
+    try {
+      log_task<2>(std::string(log_prefix) + "-f." + extension, START_F,
+                  functions::f, 1.0, log_format);
+      log_task<3>(std::string(log_prefix) + "-g." + extension, START_G,
+                  functions::g, INIT_STEP_SIZE_G, log_format);
+    } catch (const std::exception &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+  }
 
   /* ======== NON-MANDATORY PART
    * =========================================================== */
 
   /* Initialize Gui */
-  auto gui = GuiHandle();
+  auto gui = GuiHandle(heatmap_resolution, heatmap_precision, heatmap_cache);
+  if (record_path != nullptr) {
+    gui.StartRecording();
+  }
+  if (connect_endpoint != nullptr) {
+    gui.Connect(connect_endpoint);
+    if (attach_run) {
+      gui.Attach(*attach_run);
+    }
+  }
 
   /* Update and run Gui */
   while (true) {
     if (gui.Update()) {
+      if (record_path != nullptr) {
+        gui.Recording().Save(record_path);
+      }
       return 0;
     }
   }
@@ -0,0 +1,320 @@
+#ifndef MEMO_CACHE_H_
+#define MEMO_CACHE_H_
+/**
+ * @file memo_cache.hpp
+ *
+ * @brief Bounded caches of objective values keyed by the exact point.
+ *
+ * Gradient descent evaluates the same points again and again: the centre
+ * of every gradient stencil N times, and each iteration's next or test
+ * point once more as the following iteration's current point. For
+ * expensive objectives, e.g. external ones, a cache saves those calls.
+ *
+ * Keys are the exact bit patterns of the coordinates, so a hit returns what
+ * the objective would have returned and results do not change. -0.0 and
+ * 0.0 are different keys.
+ *
+ * - `MemoTable` is a single-threaded, set-associative open-addressing table:
+ * a point hashes to one set of `WAYS` adjacent entries and replaces the
+ * least recently used one of them. Lookups touch one or two cache lines and
+ * never allocate.
+ * - `ShardedMemoTable` splits the entries among `SHARDS` tables with one
+ * lock each, for use from many threads. The objective is called outside
+ * the lock.
+ * - `MemoizedObjective` turns a sharded table and an objective into a
+ * `FunctionPtr` for the optimizers.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/** Counters of a memoization table. */
+struct MemoStats {
+  uint64_t hits{0};
+  uint64_t misses{0};
+  /** Entries replaced to make room. */
+  uint64_t evictions{0};
+
+  [[nodiscard]] double hit_rate() const {
+    const uint64_t lookups = hits + misses;
+    return lookups == 0 ? 0.0
+                        : static_cast<double>(hits) /
+                              static_cast<double>(lookups);
+  }
+
+  MemoStats &operator+=(const MemoStats &other) {
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+    return *this;
+  }
+};
+
+/** Bounded single-threaded cache of values of an N-dimensional objective. */
+template <std::size_t N> class MemoTable {
+public:
+  /** Entries per set. */
+  static constexpr std::size_t WAYS = 4;
+
+  /** Room for at least `capacity` entries, rounded up to a power of two
+   * and at least one set. */
+  explicit MemoTable(std::size_t capacity);
+
+  /** Hash of the bits of `x`, shared with `ShardedMemoTable`. */
+  [[nodiscard]] static uint64_t Hash(const CMyVektor<N> &x);
+
+  /** Value stored for `x`. Counts a hit or a miss. */
+  [[nodiscard]] std::optional<double> Lookup(const CMyVektor<N> &x,
+                                             uint64_t hash);
+
+  /** Store `value` for `x`, replacing the least recently used entry of its
+   * set if the set is full. */
+  void Insert(const CMyVektor<N> &x, uint64_t hash, double value);
+
+  /** Value for `x`, computed with `compute()` on a miss. */
+  template <typename Compute>
+  double GetOrCompute(const CMyVektor<N> &x, Compute &&compute);
+
+  [[nodiscard]] std::size_t capacity() const { return entries.size(); }
+
+  [[nodiscard]] const MemoStats &stats() const { return counters; }
+
+  /** Drop all entries. Keeps the counters. */
+  void Clear();
+
+private:
+  using Key = std::array<uint64_t, N>;
+
+  struct Entry {
+    Key key{};
+    double value{};
+    /** `clock` at the last use. Zero marks an empty entry. */
+    uint64_t used{0};
+  };
+
+  std::vector<Entry> entries;
+  std::size_t set_mask;
+  uint64_t clock{0};
+  MemoStats counters{};
+
+  [[nodiscard]] static Key key_of(const CMyVektor<N> &x);
+  [[nodiscard]] Entry *set_of(uint64_t hash) {
+    return entries.data() + (hash & set_mask) * WAYS;
+  }
+};
+
+/** `MemoTable` split into independently locked shards. */
+template <std::size_t N> class ShardedMemoTable {
+public:
+  static constexpr std::size_t SHARDS = 16;
+
+  /** Room for at least `capacity` entries in total. */
+  explicit ShardedMemoTable(std::size_t capacity);
+
+  /** Value for `x`, computed with `compute()` on a miss. Thread-safe.
+   * Threads missing the same point at the same time both compute it. */
+  template <typename Compute>
+  double GetOrCompute(const CMyVektor<N> &x, Compute &&compute);
+
+  /** Sum over all shards. */
+  [[nodiscard]] MemoStats stats() const;
+
+  [[nodiscard]] std::size_t capacity() const;
+
+private:
+  struct alignas(64) Shard {
+    explicit Shard(std::size_t capacity) : table(capacity) {}
+
+    mutable std::mutex mutex{};
+    MemoTable<N> table;
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards{};
+
+  /** The table uses the low bits of the hash, shards the high ones. */
+  [[nodiscard]] Shard &shard_of(uint64_t hash) {
+    return *shards[hash >> (64 - std::bit_width(SHARDS - 1))];
+  }
+};
+
+/**
+ * Objective of dimension N with memoized values.
+ *
+ * While an instance exists, `function()` evaluates through its table on any
+ * thread, e.g. in the workers of `RunBatch`. Instances of the same N nest:
+ * the newest one wins until it is destroyed.
+ */
+template <std::size_t N> class MemoizedObjective {
+public:
+  MemoizedObjective(FunctionPtr<N> funktion, std::size_t capacity);
+  ~MemoizedObjective();
+
+  MemoizedObjective(const MemoizedObjective &) = delete;
+  MemoizedObjective &operator=(const MemoizedObjective &) = delete;
+
+  /** The objective for the optimizers. */
+  [[nodiscard]] static FunctionPtr<N> function() { return evaluate; }
+
+  [[nodiscard]] MemoStats stats() const { return table.stats(); }
+
+private:
+  static inline std::atomic<MemoizedObjective *> active{nullptr};
+
+  FunctionPtr<N> funktion;
+  ShardedMemoTable<N> table;
+  MemoizedObjective *previous;
+
+  static double evaluate(const CMyVektor<N> &x);
+};
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+
+template <std::size_t N>
+MemoTable<N>::MemoTable(std::size_t capacity)
+    : entries(std::bit_ceil(std::max(capacity, WAYS))),
+      set_mask(entries.size() / WAYS - 1) {}
+
+template <std::size_t N>
+typename MemoTable<N>::Key MemoTable<N>::key_of(const CMyVektor<N> &x) {
+  Key key;
+  for (std::size_t i = 0; i < N; i++) {
+    key[i] = std::bit_cast<uint64_t>(x[i]);
+  }
+  return key;
+}
+
+template <std::size_t N> uint64_t MemoTable<N>::Hash(const CMyVektor<N> &x) {
+  /* Multiply-xorshift mixing of every coordinate, good enough to spread
+   * nearby points over all sets. */
+  uint64_t hash = 0x9E3779B97F4A7C15ULL;
+  for (std::size_t i = 0; i < N; i++) {
+    hash ^= std::bit_cast<uint64_t>(x[i]);
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 31;
+  }
+  hash *= 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 29);
+}
+
+template <std::size_t N>
+std::optional<double> MemoTable<N>::Lookup(const CMyVektor<N> &x,
+                                           uint64_t hash) {
+  const Key key = key_of(x);
+  Entry *set = set_of(hash);
+  for (std::size_t way = 0; way < WAYS; way++) {
+    if (set[way].used != 0 && set[way].key == key) {
+      set[way].used = ++clock;
+      counters.hits++;
+      return set[way].value;
+    }
+  }
+  counters.misses++;
+  return std::nullopt;
+}
+
+template <std::size_t N>
+void MemoTable<N>::Insert(const CMyVektor<N> &x, uint64_t hash,
+                          double value) {
+  const Key key = key_of(x);
+  Entry *set = set_of(hash);
+  Entry *victim = set;
+  for (std::size_t way = 0; way < WAYS; way++) {
+    if (set[way].used != 0 && set[way].key == key) {
+      victim = set + way;
+      break;
+    }
+    if (set[way].used < victim->used) {
+      victim = set + way;
+    }
+  }
+  if (victim->used != 0 && victim->key != key) {
+    counters.evictions++;
+  }
+  *victim = Entry{key, value, ++clock};
+}
+
+template <std::size_t N>
+template <typename Compute>
+double MemoTable<N>::GetOrCompute(const CMyVektor<N> &x, Compute &&compute) {
+  const uint64_t hash = Hash(x);
+  if (const auto cached = Lookup(x, hash)) {
+    return *cached;
+  }
+  const double value = compute();
+  Insert(x, hash, value);
+  return value;
+}
+
+template <std::size_t N> void MemoTable<N>::Clear() {
+  std::fill(entries.begin(), entries.end(), Entry{});
+  clock = 0;
+}
+
+template <std::size_t N>
+ShardedMemoTable<N>::ShardedMemoTable(std::size_t capacity) {
+  static_assert(std::has_single_bit(SHARDS));
+  shards.reserve(SHARDS);
+  for (std::size_t i = 0; i < SHARDS; i++) {
+    shards.push_back(
+        std::make_unique<Shard>((capacity + SHARDS - 1) / SHARDS));
+  }
+}
+
+template <std::size_t N>
+template <typename Compute>
+double ShardedMemoTable<N>::GetOrCompute(const CMyVektor<N> &x,
+                                         Compute &&compute) {
+  const uint64_t hash = MemoTable<N>::Hash(x);
+  Shard &shard = shard_of(hash);
+  {
+    const std::lock_guard lock(shard.mutex);
+    if (const auto cached = shard.table.Lookup(x, hash)) {
+      return *cached;
+    }
+  }
+  const double value = compute();
+  const std::lock_guard lock(shard.mutex);
+  shard.table.Insert(x, hash, value);
+  return value;
+}
+
+template <std::size_t N> MemoStats ShardedMemoTable<N>::stats() const {
+  MemoStats total{};
+  for (const auto &shard : shards) {
+    const std::lock_guard lock(shard->mutex);
+    total += shard->table.stats();
+  }
+  return total;
+}
+
+template <std::size_t N> std::size_t ShardedMemoTable<N>::capacity() const {
+  return shards.front()->table.capacity() * SHARDS;
+}
+
+template <std::size_t N>
+MemoizedObjective<N>::MemoizedObjective(FunctionPtr<N> funktion,
+                                        std::size_t capacity)
+    : funktion(funktion), table(capacity), previous(active.exchange(this)) {}
+
+template <std::size_t N> MemoizedObjective<N>::~MemoizedObjective() {
+  active = previous;
+}
+
+template <std::size_t N>
+double MemoizedObjective<N>::evaluate(const CMyVektor<N> &x) {
+  MemoizedObjective &self = *active.load();
+  return self.table.GetOrCompute(x, [&] { return self.funktion(x); });
+}
+
+#endif // MEMO_CACHE_H_
@@ -0,0 +1,49 @@
+/**
+ * @file objective_worker.cpp
+ *
+ * @brief Objective worker process evaluating the compiled-in objectives.
+ *
+ * Reference implementation of worker_protocol.hpp and a stand-in for
+ * external simulators, e.g. to compare out-of-process runs with in-process
+ * ones.
+ *
+ * Usage: `plottings-worker f|g`.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "functions.hpp"
+#include "worker_protocol.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <string_view>
+
+namespace {
+template <std::size_t N> void serve(FunctionPtr<N> funktion) {
+  worker_protocol::Serve(N, [funktion](const double *x) {
+    CMyVektor<N> point{};
+    std::copy(x, x + N, point.begin());
+    return funktion(point);
+  });
+}
+} // namespace
+
+auto main(int argc, char **argv) -> int {
+  const std::string_view objective = argc > 1 ? argv[1] : "";
+  try {
+    if (objective == "f") {
+      serve<2>(functions::f);
+    } else if (objective == "g") {
+      serve<3>(functions::g);
+    } else {
+      std::cerr << "usage: plottings-worker f|g" << std::endl;
+      return 2;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
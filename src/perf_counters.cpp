@@ -0,0 +1,116 @@
+/**
+ * @file perf_counters.cpp
+ *
+ * @brief perf_event_open backend of the hardware counters.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "perf_counters.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+constexpr uint64_t CONFIGS[PerfSample::EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+constexpr const char *NAMES[PerfSample::EVENTS] = {
+    "cycles", "instructions", "cache misses", "branch misses"};
+
+int open_counter(uint64_t config) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  /* This thread on any CPU. */
+  return static_cast<int>(
+      syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+} // namespace
+
+PerfCounters::PerfCounters() {
+  for (std::size_t i = 0; i < PerfSample::EVENTS; i++) {
+    fds[i] = open_counter(CONFIGS[i]);
+    if (fds[i] < 0) {
+      error_ += std::string(error_.empty() ? "" : ", ") + NAMES[i] + ": " +
+                std::strerror(errno);
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const int fd : fds) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+bool PerfCounters::available() const {
+  for (const int fd : fds) {
+    if (fd >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void PerfCounters::Start() {
+  for (const int fd : fds) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+PerfSample PerfCounters::Stop() {
+  for (const int fd : fds) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+  PerfSample sample{};
+  for (std::size_t i = 0; i < PerfSample::EVENTS; i++) {
+    /* value, time enabled, time running */
+    uint64_t values[3]{};
+    if (fds[i] < 0 || read(fds[i], values, sizeof(values)) !=
+                          static_cast<ssize_t>(sizeof(values))) {
+      continue;
+    }
+    if (values[2] == 0) {
+      /* Never scheduled, e.g. all counters taken by another process. */
+      continue;
+    }
+    sample.counts[i] = static_cast<double>(values[0]) *
+                       static_cast<double>(values[1]) /
+                       static_cast<double>(values[2]);
+  }
+  return sample;
+}
+#else
+PerfCounters::PerfCounters()
+    : error_("Hardware counters need perf_event_open (Linux)") {
+  fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters() = default;
+
+bool PerfCounters::available() const { return false; }
+
+void PerfCounters::Start() {}
+
+PerfSample PerfCounters::Stop() { return PerfSample{}; }
+#endif
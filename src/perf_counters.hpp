@@ -0,0 +1,65 @@
+#ifndef PERF_COUNTERS_H_
+#define PERF_COUNTERS_H_
+/**
+ * @file perf_counters.hpp
+ *
+ * @brief Hardware performance counters of the calling thread.
+ *
+ * Counters are opened with `perf_event_open` for user space only, which
+ * works with the default `perf_event_paranoid` level of most distributions.
+ * Every counter that cannot be opened, because the kernel forbids it, the
+ * CPU lacks it or the system is not Linux, is reported as missing and the
+ * others keep working.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/** The counted hardware events. */
+enum class PerfEvent { Cycles, Instructions, CacheMisses, BranchMisses };
+
+/** Counts between `PerfCounters::Start` and `Stop`, by `PerfEvent`. Missing
+ * counters are empty. Multiplexed counters are scaled to the full time. */
+struct PerfSample {
+  static constexpr std::size_t EVENTS = 4;
+  std::array<std::optional<double>, EVENTS> counts{};
+
+  [[nodiscard]] std::optional<double> operator[](PerfEvent event) const {
+    return counts[static_cast<std::size_t>(event)];
+  }
+};
+
+/** Counters of the calling thread. Not copyable, the file descriptors are
+ * closed on destruction. */
+class PerfCounters {
+public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  /** Whether at least one counter could be opened. */
+  [[nodiscard]] bool available() const;
+
+  /** Why counters are missing, empty if all are there. */
+  [[nodiscard]] const std::string &error() const { return error_; }
+
+  /** Reset and start all counters. */
+  void Start();
+
+  /** Stop all counters and read them. */
+  [[nodiscard]] PerfSample Stop();
+
+private:
+  /** File descriptor by `PerfEvent`, -1 if missing. */
+  std::array<int, PerfSample::EVENTS> fds{};
+  std::string error_{};
+};
+
+#endif // PERF_COUNTERS_H_
@@ -0,0 +1,127 @@
+/**
+ * @file playback.cpp
+ *
+ * @brief Implementation of the animated playback.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "playback.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void Playback::clear() {
+  path_x_.clear();
+  path_y_.clear();
+  path_iterations.clear();
+  has_tail = false;
+}
+
+void Playback::append(std::size_t iteration, const CMyVektor<2> &point) {
+  path_x_.push_back(point[0]);
+  path_y_.push_back(point[1]);
+  path_iterations.push_back(iteration);
+}
+
+void Playback::thin() {
+  /* Samples sit at multiples of the stride, so every second one is kept. */
+  const std::size_t kept = (path_iterations.size() + 1) / 2;
+  for (std::size_t i = 0; i < kept; i++) {
+    path_x_[i] = path_x_[2 * i];
+    path_y_[i] = path_y_[2 * i];
+    path_iterations[i] = path_iterations[2 * i];
+  }
+  path_x_.resize(kept);
+  path_y_.resize(kept);
+  path_iterations.resize(kept);
+  stride_ *= 2;
+}
+
+void Playback::Sync(const CalcModel &model) {
+  const bool init = model.state() == CalcModel::CalcState::Init;
+  const std::size_t last = model.last_iteration();
+  if (init || model.start() != start ||
+      model.max_iterations() != max_iterations ||
+      (!path_iterations.empty() && last < path_iterations.back())) {
+    clear();
+    start = model.start();
+    max_iterations = model.max_iterations();
+    stride_ = 1;
+    position = 0.0;
+    if (init) {
+      playing_ = false;
+      return;
+    }
+  }
+  if (!path_iterations.empty() && path_iterations.back() == last) {
+    return;
+  }
+
+  if (has_tail) {
+    path_x_.pop_back();
+    path_y_.pop_back();
+    path_iterations.pop_back();
+    has_tail = false;
+  }
+  /* Samples are taken in increasing order, which lets the model seek
+   * forward from the previous one. */
+  while (true) {
+    if (path_iterations.size() == MAX_PATH_POINTS) {
+      thin();
+    }
+    const std::size_t next =
+        path_iterations.empty() ? 0 : path_iterations.back() + stride_;
+    if (next > last) {
+      break;
+    }
+    append(next, model.PointAt(next));
+  }
+  if (path_iterations.back() != last) {
+    append(last, model.PointAt(last));
+    has_tail = true;
+  }
+}
+
+void Playback::Play(std::size_t iteration) {
+  position = static_cast<double>(iteration);
+  playing_ = true;
+}
+
+std::optional<std::size_t> Playback::Advance(double elapsed, std::size_t last,
+                                             bool complete) {
+  if (!playing_) {
+    return std::nullopt;
+  }
+  position += elapsed * rate_;
+  if (position >= static_cast<double>(last)) {
+    position = static_cast<double>(last);
+    if (complete) {
+      playing_ = false;
+    }
+  }
+  return static_cast<std::size_t>(position);
+}
+
+CMyVektor<2> Playback::Interpolated() const {
+  if (path_iterations.empty()) {
+    return start;
+  }
+  const auto after = std::upper_bound(
+      path_iterations.begin(), path_iterations.end(), position,
+      [](double p, std::size_t iteration) {
+        return p < static_cast<double>(iteration);
+      });
+  if (after == path_iterations.begin() || after == path_iterations.end()) {
+    const std::size_t i = after == path_iterations.begin()
+                              ? 0
+                              : path_iterations.size() - 1;
+    return CMyVektor<2>{path_x_[i], path_y_[i]};
+  }
+  const auto i = static_cast<std::size_t>(after - path_iterations.begin());
+  const double from = static_cast<double>(path_iterations[i - 1]);
+  const double to = static_cast<double>(path_iterations[i]);
+  const double t = (position - from) / (to - from);
+  return CMyVektor<2>{path_x_[i - 1] + t * (path_x_[i] - path_x_[i - 1]),
+                      path_y_[i - 1] + t * (path_y_[i] - path_y_[i - 1])};
+}
@@ -0,0 +1,98 @@
+#ifndef PLAYBACK_H_
+#define PLAYBACK_H_
+/**
+ * @file playback.hpp
+ *
+ * @brief Animated playback of a recorded optimization run.
+ *
+ * The points a run visits are sampled once into a path as the run comes in.
+ * Like a `Trajectory`, the path keeps at most `MAX_PATH_POINTS` samples and
+ * drops every second one whenever it is full. Playback then moves a fractional
+ * position along that path and interpolates between neighbouring samples,
+ * so animating costs no objective evaluations at all.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "calc_model.hpp"
+#include "cmyvektor.hpp"
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/** Play/pause state and sampled path of the model's run. */
+class Playback {
+public:
+  /** Iterations per second when playback starts. */
+  static constexpr double DEFAULT_RATE = 20.0;
+
+  /** Maximum number of path samples. Longer runs are sampled at every
+   * `stride()`-th iteration. Power of two. */
+  static constexpr std::size_t MAX_PATH_POINTS = 4096;
+
+  /**
+   * Extend the path by iterations the model got since the last call and
+   * start over if the model switched to another run. Call once per frame
+   * before `CalcModel::current()`.
+   */
+  void Sync(const CalcModel &model);
+
+  /** Start playing from `iteration`. */
+  void Play(std::size_t iteration);
+
+  /** Stop at the current position. */
+  void Pause() { playing_ = false; }
+
+  [[nodiscard]] bool playing() const { return playing_; }
+
+  /** Iterations per second. */
+  [[nodiscard]] double rate() const { return rate_; }
+  void set_rate(double rate) { rate_ = rate; }
+
+  /**
+   * Move on by `elapsed` seconds.
+   *
+   * Playback stops at `last`, the model's last iteration, if the run is
+   * `complete`. Otherwise it waits there for more iterations.
+   *
+   * @returns Iteration to show, or nothing if not playing.
+   */
+  std::optional<std::size_t> Advance(double elapsed, std::size_t last,
+                                     bool complete);
+
+  /** Point between the two path samples around the playback position. */
+  [[nodiscard]] CMyVektor<2> Interpolated() const;
+
+  /** Path sample coordinates for plotting. */
+  [[nodiscard]] const std::vector<double> &path_x() const { return path_x_; }
+  [[nodiscard]] const std::vector<double> &path_y() const { return path_y_; }
+
+  /** Iterations between two path samples. */
+  [[nodiscard]] std::size_t stride() const { return stride_; }
+
+private:
+  bool playing_{false};
+  double rate_{DEFAULT_RATE};
+  /** Fractional iteration that is played. */
+  double position{0.0};
+
+  /** Run the path belongs to. */
+  CMyVektor<2> start{};
+  std::size_t max_iterations{0};
+
+  std::size_t stride_{1};
+  std::vector<double> path_x_{};
+  std::vector<double> path_y_{};
+  /** Iteration of each sample. Multiples of `stride_`, except for a final
+   * sample at the end of a run that does not fall on the stride. */
+  std::vector<std::size_t> path_iterations{};
+  /** Whether the last sample is such a final sample. */
+  bool has_tail{false};
+
+  void clear();
+  /** Drop every second sample and double the stride. */
+  void thin();
+  void append(std::size_t iteration, const CMyVektor<2> &point);
+};
+
+#endif // PLAYBACK_H_
@@ -0,0 +1,112 @@
+#ifndef PLOTTINGS_H_
+#define PLOTTINGS_H_
+/**
+ * @file plottings.h
+ *
+ * @brief C interface of the gradient descent optimizer.
+ *
+ * For callers from other languages through a plain C ABI. The objective is a
+ * callback with a user data pointer, either scalar (one point per call) or
+ * batched (many points per call). Batched objectives are asked for the
+ * point and its gradient stencil at once, which needs two calls per
+ * iteration instead of `2 * dimension + 3`.
+ *
+ * All functions are re-entrant and may be called from any number of threads
+ * at the same time. An objective may itself start another optimization.
+ * The library keeps no state between calls.
+ *
+ * Results are the same as those of `gradient_descent` in iteration.hpp for
+ * the same objective, step size and iteration limit.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <stddef.h>
+
+#if defined(_WIN32)
+#if defined(PLOTTINGS_BUILDING_LIBRARY)
+#define PLOTTINGS_API __declspec(dllexport)
+#else
+#define PLOTTINGS_API __declspec(dllimport)
+#endif
+#else
+#define PLOTTINGS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Largest supported dimension. */
+#define PLOTTINGS_MAX_DIMENSION 8
+
+typedef enum plottings_status {
+  PLOTTINGS_OK = 0,
+  /** A pointer is null or the dimension is not in [1, MAX_DIMENSION]. */
+  PLOTTINGS_INVALID_ARGUMENT = 1,
+} plottings_status;
+
+/** Value of the objective at `x[0 .. dimension)`. */
+typedef double (*plottings_objective)(const double *x, size_t dimension,
+                                      void *user_data);
+
+/**
+ * Store the objective at `count` points in `values[0 .. count)`. Point i is
+ * `points[i * dimension .. (i + 1) * dimension)`.
+ */
+typedef void (*plottings_batch_objective)(const double *points, size_t count,
+                                          size_t dimension, double *values,
+                                          void *user_data);
+
+typedef struct plottings_options {
+  /** Number of coordinates, 1 to PLOTTINGS_MAX_DIMENSION. */
+  size_t dimension;
+  /** Initial step size lambda. */
+  double step_size;
+  /** Iteration limit. */
+  size_t max_iterations;
+} plottings_options;
+
+typedef struct plottings_result {
+  /** Last point, the first `dimension` entries are used. */
+  double x[PLOTTINGS_MAX_DIMENSION];
+  /** Objective at `x`. */
+  double value;
+  /** Norm of the gradient at `x`. */
+  double gradient_norm;
+  size_t iterations;
+  /** Points the objective was evaluated at. */
+  size_t evaluations;
+  /** Calls of the objective callback. */
+  size_t callback_calls;
+  /** Non-zero if the gradient norm fell below the convergence limit. */
+  int converged;
+} plottings_result;
+
+/** Options of the exercise: step size 1 and its iteration limit. */
+PLOTTINGS_API plottings_options plottings_default_options(size_t dimension);
+
+/**
+ * Maximize `objective` by gradient descent from `start[0 .. dimension)`.
+ *
+ * @returns PLOTTINGS_OK and fills `result`, or an error without calling
+ * the objective.
+ */
+PLOTTINGS_API plottings_status plottings_gradient_descent(
+    const double *start, const plottings_options *options,
+    plottings_objective objective, void *user_data, plottings_result *result);
+
+/** Same as `plottings_gradient_descent` with a batched objective. */
+PLOTTINGS_API plottings_status plottings_gradient_descent_batched(
+    const double *start, const plottings_options *options,
+    plottings_batch_objective objective, void *user_data,
+    plottings_result *result);
+
+/** Static description of `status`. */
+PLOTTINGS_API const char *plottings_status_string(plottings_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLOTTINGS_H_ */
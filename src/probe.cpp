@@ -0,0 +1,64 @@
+/**
+ * @file probe.cpp
+ *
+ * @brief Implementation of the background probe.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "probe.hpp"
+#include "trace.hpp"
+
+Probe::Probe(FunctionPtr<2> funktion)
+    : funktion(funktion), worker(&Probe::run, this) {}
+
+Probe::~Probe() {
+  {
+    const std::lock_guard lock(mutex);
+    stop = true;
+  }
+  wake.notify_one();
+  worker.join();
+}
+
+void Probe::Request(const CMyVektor<2> &position) {
+  {
+    const std::lock_guard lock(mutex);
+    if ((result && result->position == position) ||
+        (pending && *pending == position)) {
+      return;
+    }
+    pending = position;
+  }
+  wake.notify_one();
+}
+
+std::optional<Probe::Result>
+Probe::Lookup(const CMyVektor<2> &position) const {
+  const std::lock_guard lock(mutex);
+  if (result && result->position == position) {
+    return result;
+  }
+  return std::nullopt;
+}
+
+void Probe::run() {
+  TRACE_THREAD_NAME("Probe");
+  std::unique_lock lock(mutex);
+  while (true) {
+    wake.wait(lock, [this] { return stop || pending.has_value(); });
+    if (stop) {
+      return;
+    }
+    const CMyVektor<2> position = *pending;
+    pending.reset();
+
+    lock.unlock();
+    TRACE_SCOPE("Probe");
+    const Result computed{
+        position, evaluate(funktion, position, eval_profile::Site::Probe),
+        position.gradient(funktion)};
+    lock.lock();
+    result = computed;
+  }
+}
@@ -0,0 +1,65 @@
+#ifndef PROBE_H_
+#define PROBE_H_
+/**
+ * @file probe.hpp
+ *
+ * @brief Exact function evaluation in the background for the hover probe.
+ *
+ * The UI shows values under the mouse cursor. Evaluating the objective
+ * there may be slow, so the UI first shows an estimate interpolated from
+ * the heatmap and asks the `Probe` for the exact values. The probe's thread
+ * only ever works on the latest request; positions the cursor has already
+ * left are skipped.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+/** Background evaluator of a 2D function and its gradient. */
+class Probe {
+public:
+  /** Exact values at `position`. */
+  struct Result {
+    CMyVektor<2> position{};
+    double value{};
+    CMyVektor<2> gradient{};
+  };
+
+  explicit Probe(FunctionPtr<2> funktion);
+
+  /** Stops the thread. Waits for an evaluation in progress. */
+  ~Probe();
+
+  Probe(const Probe &) = delete;
+  Probe &operator=(const Probe &) = delete;
+
+  /** Evaluate at `position` as soon as possible. Replaces any request that
+   * has not been started yet. */
+  void Request(const CMyVektor<2> &position);
+
+  /** Exact result for `position` if it has already been computed. */
+  [[nodiscard]] std::optional<Result>
+  Lookup(const CMyVektor<2> &position) const;
+
+private:
+  FunctionPtr<2> funktion;
+
+  mutable std::mutex mutex{};
+  std::condition_variable wake{};
+  /** Latest unprocessed request. Protected by `mutex`. */
+  std::optional<CMyVektor<2>> pending{};
+  /** Latest result. Protected by `mutex`. */
+  std::optional<Result> result{};
+  bool stop{false};
+
+  std::thread worker;
+
+  void run();
+};
+
+#endif // PROBE_H_
@@ -0,0 +1,305 @@
+#ifndef PROTOCOL_H_
+#define PROTOCOL_H_
+/**
+ * @file protocol.hpp
+ *
+ * @brief Binary protocol between the compute server and its clients.
+ *
+ * Every message is a fixed 8-byte `Header` followed by `Header::length`
+ * payload bytes. All values are sent in host byte order, so client and
+ * server must run on little-endian machines.
+ *
+ * A client starts a run with `StartRun` or attaches to a run in progress
+ * with `Attach`. The server answers with `RunStarted` and then streams the
+ * iterations as `Records` batches until `RunEnd`. A connection streams one
+ * run at a time.
+ *
+ * Independently of runs, a client may send any number of `Optimize` jobs
+ * without waiting for answers. Each job is answered with one `Results`
+ * message carrying the final point of every start point. Answers to
+ * different jobs may arrive in any order and are told apart by `job_id`.
+ * Requests whose objective, step size or iteration limit fail
+ * `CheckOptions` are answered with `Error` instead.
+ *
+ * One iteration is sent as `4 * N + 4` doubles: step size, current point,
+ * its value, gradient, next point, its value, test point and its value. The
+ * iteration index follows from the position in the batch. One result is
+ * sent as `N + 4` 8-byte values: final point, its value and gradient norm
+ * as doubles, then the iteration count and a converged flag as uint64.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "iteration.hpp"
+#include "socket.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little,
+              "The compute protocol sends values in host byte order.");
+
+namespace protocol {
+
+/** Message type. */
+enum class Type : uint8_t {
+  /** Client: `StartRun` followed by the start point. */
+  StartRun = 1,
+  /** Client: `Attach`. */
+  Attach = 2,
+  /** Client: `Optimize` followed by `count` start points. */
+  Optimize = 3,
+  /** Server: `RunStarted`. */
+  RunStarted = 16,
+  /** Server: `Records` followed by `count` iterations. */
+  Records = 17,
+  /** Server: `RunEnd`. */
+  RunEnd = 18,
+  /** Server: Error message text. */
+  Error = 19,
+  /** Server: `Results` followed by `count` results. */
+  Results = 20,
+};
+
+/** Objectives known to the server. */
+enum class Objective : uint8_t {
+  /** `functions::f`, two dimensions. */
+  F = 0,
+  /** `functions::g`, three dimensions. */
+  G = 1,
+};
+
+/** Largest iteration limit of `StartRun` and `Optimize`, so that one
+ * request cannot keep the server busy indefinitely. */
+inline constexpr uint64_t MAX_ITERATIONS = 1000000;
+
+/** Throw `std::runtime_error` unless `objective` is known, `step_size` is
+ * finite and positive and `max_iterations` is in [1, MAX_ITERATIONS]. */
+inline void CheckOptions(Objective objective, double step_size,
+                         uint64_t max_iterations) {
+  if (objective != Objective::F && objective != Objective::G) {
+    throw std::runtime_error("Unknown objective");
+  }
+  if (!std::isfinite(step_size) || step_size <= 0.0) {
+    throw std::runtime_error("Step size must be finite and positive");
+  }
+  if (max_iterations == 0 || max_iterations > MAX_ITERATIONS) {
+    throw std::runtime_error("Iteration limit must be between 1 and " +
+                             std::to_string(MAX_ITERATIONS));
+  }
+}
+
+/** Pre-image dimension of `objective`. */
+constexpr auto dimension(Objective objective) -> std::size_t {
+  return objective == Objective::F ? 2 : 3;
+}
+
+struct Header {
+  Type type{};
+  uint8_t reserved[3]{};
+  /** Payload size in bytes. */
+  uint32_t length{};
+};
+static_assert(sizeof(Header) == 8);
+
+/** Start a new run. Followed by `dimension(objective)` doubles. */
+struct StartRun {
+  Objective objective{};
+  uint8_t reserved[7]{};
+  double step_size{};
+  uint64_t max_iterations{};
+};
+static_assert(sizeof(StartRun) == 24);
+
+/** Stream an existing run starting at iteration `from_index`. */
+struct Attach {
+  uint32_t run_id{};
+  uint32_t reserved{};
+  uint64_t from_index{};
+};
+static_assert(sizeof(Attach) == 16);
+
+/** Answer to `StartRun` or `Attach`. */
+struct RunStarted {
+  uint32_t run_id{};
+  uint32_t dimension{};
+};
+static_assert(sizeof(RunStarted) == 8);
+
+/** Batch of consecutive iterations. */
+struct Records {
+  uint32_t run_id{};
+  uint32_t dimension{};
+  /** Iteration index of the first record in the batch. */
+  uint64_t first_index{};
+  /** Number of records in the batch. */
+  uint64_t count{};
+};
+static_assert(sizeof(Records) == 24);
+
+/** The run is finished and all its records have been sent. */
+struct RunEnd {
+  uint32_t run_id{};
+  uint32_t reserved{};
+  /** Total number of iterations of the run. */
+  uint64_t size{};
+};
+static_assert(sizeof(RunEnd) == 16);
+
+/** Optimize from each of `count` start points of `dimension(objective)`
+ * doubles that follow. */
+struct Optimize {
+  /** Chosen by the client, repeated in the answer. */
+  uint64_t job_id{};
+  Objective objective{};
+  uint8_t reserved[7]{};
+  double step_size{};
+  uint64_t max_iterations{};
+  uint64_t count{};
+};
+static_assert(sizeof(Optimize) == 40);
+
+/** Answer to `Optimize`, results in the order of the start points. */
+struct Results {
+  uint64_t job_id{};
+  uint32_t dimension{};
+  uint32_t reserved{};
+  uint64_t count{};
+};
+static_assert(sizeof(Results) == 24);
+
+/** Size of one encoded result in bytes. */
+constexpr auto result_size(std::size_t dim) -> std::size_t {
+  return (dim + 4) * sizeof(double);
+}
+
+/** Write one result to `out`, which has `result_size(N)` bytes. */
+template <std::size_t N>
+void EncodeResult(const Point<N> &end, double gradient_norm,
+                  uint64_t iterations, bool converged, uint8_t *out) {
+  std::memcpy(out, end.vector.data(), N * sizeof(double));
+  out += N * sizeof(double);
+  std::memcpy(out, &end.value, sizeof(double));
+  out += sizeof(double);
+  std::memcpy(out, &gradient_norm, sizeof(double));
+  out += sizeof(double);
+  std::memcpy(out, &iterations, sizeof(uint64_t));
+  out += sizeof(uint64_t);
+  const uint64_t flag = converged ? 1 : 0;
+  std::memcpy(out, &flag, sizeof(uint64_t));
+}
+
+/** Size of one encoded iteration in bytes. */
+constexpr auto record_size(std::size_t dim) -> std::size_t {
+  return (4 * dim + 4) * sizeof(double);
+}
+
+/** Append `iteration` to `out` in record encoding. */
+template <std::size_t N>
+void EncodeIteration(const IterationData<N> &iteration,
+                     std::vector<uint8_t> &out) {
+  double record[4 * N + 4];
+  double *it = record;
+  auto write_point = [&it](const Point<N> &point) {
+    it = std::copy(point.vector.begin(), point.vector.end(), it);
+    *it++ = point.value;
+  };
+  *it++ = iteration.step_size;
+  write_point(iteration.current);
+  it = std::copy(iteration.current_grad.begin(), iteration.current_grad.end(),
+                 it);
+  write_point(iteration.next);
+  write_point(iteration.test);
+  const auto *bytes = reinterpret_cast<const uint8_t *>(record);
+  out.insert(out.end(), bytes, bytes + sizeof(record));
+}
+
+/**
+ * Decode one record. The objective is not part of the record, so the
+ * result can be displayed but not advanced with `IterationData::Next`.
+ */
+template <std::size_t N>
+IterationData<N> DecodeIteration(const uint8_t *data, std::size_t index) {
+  double record[4 * N + 4];
+  std::memcpy(record, data, sizeof(record));
+  const double *it = record;
+  IterationData<N> ret{};
+  ret.index = index;
+  ret.step_size = *it++;
+  auto read_point = [&it](Point<N> &point) {
+    std::copy(it, it + N, point.vector.begin());
+    it += N;
+    point.value = *it++;
+  };
+  read_point(ret.current);
+  std::copy(it, it + N, ret.current_grad.begin());
+  it += N;
+  read_point(ret.next);
+  read_point(ret.test);
+  return ret;
+}
+
+/** Send one message consisting of header, `head` and `tail`. */
+inline void Send(const Socket &socket, Type type, const void *head,
+                 std::size_t head_size, const void *tail = nullptr,
+                 std::size_t tail_size = 0) {
+  std::vector<uint8_t> buffer(sizeof(Header) + head_size + tail_size);
+  Header header{};
+  header.type = type;
+  header.length = static_cast<uint32_t>(head_size + tail_size);
+  std::memcpy(buffer.data(), &header, sizeof(header));
+  if (head_size > 0) {
+    std::memcpy(buffer.data() + sizeof(header), head, head_size);
+  }
+  if (tail_size > 0) {
+    std::memcpy(buffer.data() + sizeof(header) + head_size, tail, tail_size);
+  }
+  socket.WriteAll(buffer.data(), buffer.size());
+}
+
+/** Send a message whose payload is the struct `payload`. */
+template <typename T>
+void Send(const Socket &socket, Type type, const T &payload) {
+  Send(socket, type, &payload, sizeof(payload));
+}
+
+/** Largest accepted payload. Protects against garbage on the wire. */
+static constexpr uint32_t MAX_PAYLOAD = 64 * 1024 * 1024;
+
+/**
+ * Receive one message.
+ *
+ * @returns 'false' if the peer closed the connection.
+ */
+inline bool Receive(const Socket &socket, Header &header,
+                    std::vector<uint8_t> &payload) {
+  if (!socket.ReadExact(&header, sizeof(header))) {
+    return false;
+  }
+  if (header.length > MAX_PAYLOAD) {
+    throw std::runtime_error("Protocol message too large");
+  }
+  payload.resize(header.length);
+  if (header.length > 0 && !socket.ReadExact(payload.data(), header.length)) {
+    throw std::runtime_error("Connection closed in the middle of a message");
+  }
+  return true;
+}
+
+/** Read a struct `T` from the start of `payload`. */
+template <typename T> T Read(const std::vector<uint8_t> &payload) {
+  if (payload.size() < sizeof(T)) {
+    throw std::runtime_error("Protocol message too short");
+  }
+  T ret;
+  std::memcpy(&ret, payload.data(), sizeof(T));
+  return ret;
+}
+} // namespace protocol
+
+#endif // PROTOCOL_H_
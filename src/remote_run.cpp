@@ -0,0 +1,119 @@
+/**
+ * @file remote_run.cpp
+ *
+ * @brief Implementation of the compute server client.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "remote_run.hpp"
+#include "protocol.hpp"
+
+#include <algorithm>
+
+RemoteRun::~RemoteRun() { disconnect(); }
+
+void RemoteRun::disconnect() {
+  socket.Shutdown();
+  if (receiver.joinable()) {
+    receiver.join();
+  }
+  socket = Socket{};
+}
+
+void RemoteRun::connect() {
+  disconnect();
+  {
+    const std::lock_guard lock(mutex);
+    iterations.clear();
+    error_.clear();
+  }
+  run_id_ = 0;
+  finished_ = false;
+  failed_ = false;
+  socket = Socket::Connect(endpoint);
+}
+
+void RemoteRun::Start(const CMyVektor<2> &start, double step_size,
+                      std::size_t max_iterations) {
+  connect();
+  protocol::StartRun request{};
+  request.objective = protocol::Objective::F;
+  request.step_size = step_size;
+  request.max_iterations = max_iterations;
+  protocol::Send(socket, protocol::Type::StartRun, &request, sizeof(request),
+                 start.data(), sizeof(double) * start.size());
+  receiver = std::thread(&RemoteRun::receive, this);
+}
+
+void RemoteRun::Attach(uint32_t run_id) {
+  connect();
+  protocol::Send(socket, protocol::Type::Attach,
+                 protocol::Attach{run_id, 0, 0});
+  receiver = std::thread(&RemoteRun::receive, this);
+}
+
+std::size_t RemoteRun::size() const {
+  const std::lock_guard lock(mutex);
+  return iterations.size();
+}
+
+IterationData<2> RemoteRun::At(std::size_t position) const {
+  const std::lock_guard lock(mutex);
+  return iterations[std::min(position, iterations.size() - 1)];
+}
+
+std::string RemoteRun::error() const {
+  const std::lock_guard lock(mutex);
+  return error_;
+}
+
+void RemoteRun::receive() {
+  static constexpr std::size_t RECORD_SIZE = protocol::record_size(2);
+  try {
+    protocol::Header header{};
+    std::vector<uint8_t> payload;
+    std::vector<IterationData<2>> batch;
+    while (protocol::Receive(socket, header, payload)) {
+      switch (header.type) {
+      case protocol::Type::RunStarted: {
+        const auto started = protocol::Read<protocol::RunStarted>(payload);
+        if (started.dimension != 2) {
+          throw std::runtime_error("Run is not two-dimensional");
+        }
+        run_id_ = started.run_id;
+        break;
+      }
+      case protocol::Type::Records: {
+        const auto records = protocol::Read<protocol::Records>(payload);
+        if (payload.size() != sizeof(records) + records.count * RECORD_SIZE) {
+          throw std::runtime_error("Records message has wrong size");
+        }
+        /* Decode outside the lock, the UI reads concurrently. */
+        batch.clear();
+        for (std::size_t i = 0; i < records.count; i++) {
+          batch.push_back(protocol::DecodeIteration<2>(
+              payload.data() + sizeof(records) + i * RECORD_SIZE,
+              records.first_index + i));
+        }
+        const std::lock_guard lock(mutex);
+        iterations.insert(iterations.end(), batch.begin(), batch.end());
+        break;
+      }
+      case protocol::Type::RunEnd:
+        finished_ = true;
+        return;
+      case protocol::Type::Error:
+        throw std::runtime_error(
+            std::string(payload.begin(), payload.end()));
+      default:
+        throw std::runtime_error("Unexpected message type");
+      }
+    }
+    throw std::runtime_error("Server closed the connection");
+  } catch (const std::exception &e) {
+    const std::lock_guard lock(mutex);
+    error_ = e.what();
+    failed_ = true;
+  }
+}
@@ -0,0 +1,91 @@
+#ifndef REMOTE_RUN_H_
+#define REMOTE_RUN_H_
+/**
+ * @file remote_run.hpp
+ *
+ * @brief Client side of the compute server for the UI.
+ *
+ * A `RemoteRun` starts a run of `functions::f` on the compute server or
+ * attaches to a run that is already in progress. The iterations are
+ * received in a background thread and can be read at any time while more
+ * are coming in.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "iteration.hpp"
+#include "socket.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Run of `functions::f` on a compute server. */
+class RemoteRun {
+public:
+  /** @param endpoint Server endpoint, see `Socket`. */
+  explicit RemoteRun(std::string endpoint) : endpoint(std::move(endpoint)) {}
+
+  /** Disconnects and stops the receiving thread. */
+  ~RemoteRun();
+
+  RemoteRun(const RemoteRun &) = delete;
+  RemoteRun &operator=(const RemoteRun &) = delete;
+
+  /** Start a new run on the server. Drops the previous run. Throws
+   * `std::runtime_error` if the server cannot be reached. */
+  void Start(const CMyVektor<2> &start, double step_size,
+             std::size_t max_iterations);
+
+  /** Attach to the run `run_id` on the server. Drops the previous run. */
+  void Attach(uint32_t run_id);
+
+  /** Server-side id of the current run. Zero until the server answered. */
+  [[nodiscard]] uint32_t run_id() const { return run_id_.load(); }
+
+  /** Number of iterations received so far. */
+  [[nodiscard]] std::size_t size() const;
+
+  /** Returns 'true' if all iterations of the run have been received. */
+  [[nodiscard]] bool finished() const { return finished_.load(); }
+
+  /** Returns 'true' if the run ended with an error, see `error()`. No more
+   * iterations arrive then. */
+  [[nodiscard]] bool failed() const { return failed_.load(); }
+
+  /** Copy of the iteration at `position`, clamped to the received ones.
+   * Must not be called while `size()` is zero. */
+  [[nodiscard]] IterationData<2> At(std::size_t position) const;
+
+  /** Last error of the receiving thread. Empty if there was none. */
+  [[nodiscard]] std::string error() const;
+
+private:
+  std::string endpoint;
+
+  Socket socket{};
+  std::thread receiver{};
+
+  mutable std::mutex mutex{};
+  /** Received iterations. Protected by `mutex`. */
+  std::vector<IterationData<2>> iterations{};
+  /** Protected by `mutex`. */
+  std::string error_{};
+
+  std::atomic<uint32_t> run_id_{0};
+  std::atomic<bool> finished_{false};
+  std::atomic<bool> failed_{false};
+
+  /** Close the connection and wait for the receiving thread. */
+  void disconnect();
+
+  /** Drop the previous run and open a new connection. */
+  void connect();
+
+  /** Body of the receiving thread. */
+  void receive();
+};
+
+#endif // REMOTE_RUN_H_
@@ -0,0 +1,102 @@
+/**
+ * @file replay.cpp
+ *
+ * @brief Implementation of the headless input replay.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "replay.hpp"
+#include "alloc_counter.hpp"
+#include "calc_model.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+/** Value at quantile `q` of sorted `values`. */
+auto quantile(const std::vector<double> &values, double q) -> double {
+  if (values.empty()) {
+    return 0.0;
+  }
+  const auto index = static_cast<std::size_t>(
+      q * static_cast<double>(values.size() - 1) + 0.5);
+  return values[index];
+}
+} // namespace
+
+FrameStats Replay(const InputLog &log, double frame_step) {
+  using Clock = std::chrono::steady_clock;
+
+  CalcModel model{};
+  FrameStats ret{};
+  std::vector<double> frame_times;
+
+  const double end = log.events.empty() ? 0.0 : log.events.back().time;
+  /* Keeps the text panel from being optimized away. */
+  volatile std::size_t sink = 0;
+
+  /* Frames without input in this and the previous frame are steady state
+   * and must not allocate. */
+  std::size_t quiet_frames = 0;
+
+  auto next_event = log.events.begin();
+  for (std::size_t frame = 0;; frame++) {
+    const double now = static_cast<double>(frame) * frame_step;
+
+    const auto frame_start = Clock::now();
+    {
+      ALLOC_FREE_SCOPE_IF("steady-state replay frame",
+                          [&] { return quiet_frames >= 2; });
+      quiet_frames++;
+      while (next_event != log.events.end() && next_event->time <= now) {
+        model.Apply(*next_event);
+        ++next_event;
+        ret.events++;
+        quiet_frames = 0;
+      }
+      sink = sink + model.current().index;
+      if (model.state() != CalcModel::CalcState::Init) {
+        sink = sink + model.Describe().size();
+      }
+    }
+    const auto frame_end = Clock::now();
+
+    frame_times.push_back(
+        std::chrono::duration<double>(frame_end - frame_start).count());
+    if (now > end) {
+      break;
+    }
+  }
+
+  ret.frames = frame_times.size();
+  for (const double t : frame_times) {
+    ret.mean += t;
+  }
+  ret.mean /= static_cast<double>(ret.frames);
+
+  std::sort(frame_times.begin(), frame_times.end());
+  ret.p50 = quantile(frame_times, 0.50);
+  ret.p95 = quantile(frame_times, 0.95);
+  ret.p99 = quantile(frame_times, 0.99);
+  ret.max = frame_times.back();
+  return ret;
+}
+
+void FrameStats::WriteReport(const std::string &path) const {
+  std::FILE *file = std::fopen(path.c_str(), "w");
+  if (file == nullptr) {
+    throw std::runtime_error("Could not open report '" + path + "'");
+  }
+  std::fprintf(file,
+               "{\"frames\": %zu, \"events\": %zu, \"mean_s\": %.9g, "
+               "\"p50_s\": %.9g, \"p95_s\": %.9g, \"p99_s\": %.9g, "
+               "\"max_s\": %.9g}\n",
+               frames, events, mean, p50, p95, p99, max);
+  if (std::fclose(file) != 0) {
+    throw std::runtime_error("Could not write report '" + path + "'");
+  }
+}
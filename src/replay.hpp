@@ -0,0 +1,53 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+/**
+ * @file replay.hpp
+ *
+ * @brief Headless replay of recorded UI input for performance regression
+ * tests.
+ *
+ * A recorded `InputLog` is applied to a `CalcModel` against a fixed-step
+ * clock: Frame k happens at `k * frame_step` seconds and applies every event
+ * recorded up to that time. The work the UI does per frame without drawing
+ * (seeking the iteration, formatting the text panel) is timed for each
+ * frame. Drawing itself needs a window and is not covered.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "input_log.hpp"
+#include <cstddef>
+#include <string>
+
+/** Frame time statistics of a replay. All times in seconds. */
+struct FrameStats {
+  /** Number of replayed frames. */
+  std::size_t frames{};
+
+  /** Number of applied input events. */
+  std::size_t events{};
+
+  double mean{};
+  double p50{};
+  double p95{};
+  double p99{};
+  double max{};
+
+  /** Write statistics as JSON object to `path`. Throws `std::runtime_error`
+   * on failure. */
+  void WriteReport(const std::string &path) const;
+};
+
+/** Default replay clock: 60 frames per second. */
+static constexpr double REPLAY_FRAME_STEP = 1.0 / 60.0;
+
+/**
+ * Replay `log` without a window and measure the frame times.
+ *
+ * @param log Recorded input events.
+ * @param frame_step Simulated time between two frames in seconds.
+ */
+[[nodiscard]] FrameStats Replay(const InputLog &log,
+                                double frame_step = REPLAY_FRAME_STEP);
+
+#endif // REPLAY_H_
@@ -0,0 +1,527 @@
+#ifndef SAMPLER_H_
+#define SAMPLER_H_
+/**
+ * @file sampler.hpp
+ *
+ * @brief Low-discrepancy point sets in the unit cube for start points and
+ * Monte Carlo estimates.
+ *
+ * - `SobolSampler`: Sobol sequence with the direction numbers of Joe and
+ * Kuo, optionally scrambled by a random digital shift.
+ * - `HaltonSampler`: Halton sequence in the first prime bases, scrambled by
+ * a random permutation of the digits of each base.
+ * - `LatinHypercubeSampler`: `points` points with exactly one point in each
+ * of the `points` slices of every coordinate.
+ *
+ * Every sampler computes point i directly from i, without state, so any
+ * range of indices can be generated on its own: threads or processes
+ * taking disjoint ranges get disjoint parts of the same point set without
+ * talking to each other. `Fill` writes blocks coordinate by coordinate, so
+ * the loops over the points of a block run over contiguous memory.
+ *
+ * The same seed always gives the same points. Seed 0 leaves Sobol and
+ * Halton unscrambled, so Sobol point 0 is the origin.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace sampling {
+/** Highest dimension of all samplers. */
+inline constexpr std::size_t MAX_DIMENSION = 16;
+
+/** Points per block of `SamplePoints` and `Estimate`. */
+inline constexpr std::size_t BLOCK = 256;
+
+/** SplitMix64 finalizer, used to derive all random choices from the
+ * seed. */
+[[nodiscard]] constexpr uint64_t mix64(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+/** Uniform number in [0, 1) from the high 53 bits of `bits`. */
+[[nodiscard]] constexpr double unit_interval(uint64_t bits) {
+  return static_cast<double>(bits >> 11) * 0x1p-53;
+}
+
+inline void check_dimension(std::size_t dimension) {
+  if (dimension == 0 || dimension > MAX_DIMENSION) {
+    throw std::runtime_error("Unsupported sampling dimension " +
+                             std::to_string(dimension) + ", at most " +
+                             std::to_string(MAX_DIMENSION));
+  }
+}
+} // namespace sampling
+
+/** Sobol sequence of up to 2^32 points. */
+class SobolSampler {
+public:
+  static constexpr uint64_t MAX_POINTS = uint64_t{1} << 32;
+
+  /** With `seed` != 0 every coordinate is XORed with a random word. */
+  explicit SobolSampler(std::size_t dimension, uint64_t seed = 0);
+
+  [[nodiscard]] std::size_t dimension() const { return dimensions; }
+
+  /** Coordinate `d` of points [first, first + count) to
+   * `out[d * count + i]`. */
+  void Fill(uint64_t first, std::size_t count, double *out) const;
+
+private:
+  static constexpr std::size_t BITS = 32;
+  using Directions = std::array<uint32_t, BITS>;
+
+  std::size_t dimensions;
+  std::array<Directions, sampling::MAX_DIMENSION> directions{};
+  std::array<uint32_t, sampling::MAX_DIMENSION> shift{};
+
+  [[nodiscard]] static Directions directions_of(std::size_t d);
+};
+
+/** Halton sequence with random digit permutations. */
+class HaltonSampler {
+public:
+  /** `seed` 0 keeps the digits as they are. */
+  explicit HaltonSampler(std::size_t dimension, uint64_t seed = 0);
+
+  [[nodiscard]] std::size_t dimension() const { return dimensions; }
+
+  /** Coordinate `d` of points [first, first + count) to
+   * `out[d * count + i]`. */
+  void Fill(uint64_t first, std::size_t count, double *out) const;
+
+private:
+  /** The first `MAX_DIMENSION` primes. */
+  static constexpr std::array<uint32_t, sampling::MAX_DIMENSION> BASES = {
+      2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
+  static constexpr std::size_t MAX_BASE = 53;
+
+  std::size_t dimensions;
+  /** `permutation[d][digit]` replaces `digit` in base `BASES[d]`. */
+  std::array<std::array<uint8_t, MAX_BASE>, sampling::MAX_DIMENSION>
+      permutation{};
+  /** Digits per coordinate: all that still change a double. */
+  std::array<uint32_t, sampling::MAX_DIMENSION> digits{};
+
+  [[nodiscard]] double radical_inverse(std::size_t d, uint64_t index) const;
+};
+
+/** Latin hypercube of a fixed number of points. */
+class LatinHypercubeSampler {
+public:
+  /** Random strata and offsets within them from `seed`. */
+  LatinHypercubeSampler(std::size_t dimension, uint64_t points,
+                        uint64_t seed = 0);
+
+  [[nodiscard]] std::size_t dimension() const { return dimensions; }
+  [[nodiscard]] uint64_t points() const { return total; }
+
+  /** Coordinate `d` of points [first, first + count) to
+   * `out[d * count + i]`. Throws past the last point. */
+  void Fill(uint64_t first, std::size_t count, double *out) const;
+
+private:
+  std::size_t dimensions;
+  uint64_t total;
+  uint64_t seed;
+  /** Smallest all-ones mask covering [0, total). */
+  uint64_t mask;
+
+  /** Stratum of point `index` in coordinate `d`, a permutation of
+   * [0, total) for each `d`. */
+  [[nodiscard]] uint64_t stratum(std::size_t d, uint64_t index) const;
+};
+
+enum class SamplerKind { Sobol, Halton, LatinHypercube };
+
+/** Parse "sobol", "halton" or "lhs". Throws `std::runtime_error` for
+ * anything else. */
+[[nodiscard]] SamplerKind parse_sampler_kind(std::string_view name);
+
+/** One of the samplers, chosen at run time. */
+class Sampler {
+public:
+  /** `points` is only used by the Latin hypercube. */
+  Sampler(SamplerKind kind, std::size_t dimension, uint64_t points,
+          uint64_t seed);
+
+  [[nodiscard]] std::size_t dimension() const;
+
+  /** Coordinate `d` of points [first, first + count) to
+   * `out[d * count + i]`. */
+  void Fill(uint64_t first, std::size_t count, double *out) const;
+
+private:
+  std::variant<SobolSampler, HaltonSampler, LatinHypercubeSampler> sampler;
+};
+
+/** Points of a sampler in the box [lower, upper], a block at a time. */
+template <std::size_t N> class SamplePoints {
+public:
+  /** Points [first, first + count) of `sampler`, which must outlive this
+   * and have dimension N. */
+  SamplePoints(const Sampler &sampler, const CMyVektor<N> &lower,
+               const CMyVektor<N> &upper, uint64_t first, uint64_t count);
+
+  /** Store the next point in `x`. False after the last one. */
+  bool Next(CMyVektor<N> &x);
+
+private:
+  const Sampler &sampler;
+  CMyVektor<N> lower;
+  CMyVektor<N> extent;
+  uint64_t next_index;
+  uint64_t end;
+  /** Current block, coordinate by coordinate, already in the box. */
+  std::array<double, N * sampling::BLOCK> block{};
+  std::size_t block_size{0};
+  std::size_t position{0};
+};
+
+/** Monte Carlo estimate of an objective over a box. */
+template <std::size_t N> struct SampleEstimate {
+  uint64_t samples{0};
+  double sum{0.0};
+  /** Largest value seen, at `argmax`. */
+  double maximum{-std::numeric_limits<double>::infinity()};
+  CMyVektor<N> argmax{};
+
+  /** Mean value over the box. Times its volume estimates the integral. */
+  [[nodiscard]] double mean() const {
+    return samples == 0 ? 0.0 : sum / static_cast<double>(samples);
+  }
+
+  /** Combine with the estimate of a disjoint range. */
+  SampleEstimate &operator+=(const SampleEstimate &other);
+};
+
+/**
+ * Evaluate `funktion` at points [first, first + count) of `sampler` in the
+ * box [lower, upper]. Estimates of disjoint ranges add up to the estimate
+ * of their union, so ranges can be evaluated by different threads.
+ */
+template <std::size_t N>
+[[nodiscard]] SampleEstimate<N>
+Estimate(const Sampler &sampler, FunctionPtr<N> funktion,
+         const CMyVektor<N> &lower, const CMyVektor<N> &upper, uint64_t first,
+         uint64_t count);
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+
+inline SobolSampler::SobolSampler(std::size_t dimension, uint64_t seed)
+    : dimensions(dimension) {
+  sampling::check_dimension(dimension);
+  for (std::size_t d = 0; d < dimensions; d++) {
+    directions[d] = directions_of(d);
+    if (seed != 0) {
+      shift[d] = static_cast<uint32_t>(sampling::mix64(seed + d) >> 32);
+    }
+  }
+}
+
+inline SobolSampler::Directions SobolSampler::directions_of(std::size_t d) {
+  /* Primitive polynomial x^s + a_1 x^(s-1) + ... + a_(s-1) x + 1 with the
+   * bits of `a` being a_1 ... a_(s-1), and initial direction numbers m,
+   * from new-joe-kuo-6.21201. The first coordinate is van der Corput. */
+  struct Polynomial {
+    uint32_t s;
+    uint32_t a;
+    std::array<uint32_t, 6> m;
+  };
+  static constexpr std::array<Polynomial, sampling::MAX_DIMENSION - 1> TABLE{{
+      {1, 0, {1}},
+      {2, 1, {1, 3}},
+      {3, 1, {1, 3, 1}},
+      {3, 2, {1, 1, 1}},
+      {4, 1, {1, 1, 3, 3}},
+      {4, 4, {1, 3, 5, 13}},
+      {5, 2, {1, 1, 5, 5, 17}},
+      {5, 4, {1, 1, 5, 5, 5}},
+      {5, 7, {1, 1, 7, 11, 19}},
+      {5, 11, {1, 1, 5, 1, 1}},
+      {5, 13, {1, 1, 1, 3, 11}},
+      {5, 14, {1, 3, 5, 5, 31}},
+      {6, 1, {1, 3, 3, 9, 7, 49}},
+      {6, 13, {1, 1, 1, 15, 21, 21}},
+      {6, 16, {1, 3, 1, 13, 27, 49}},
+  }};
+
+  Directions v{};
+  if (d == 0) {
+    for (std::size_t k = 0; k < BITS; k++) {
+      v[k] = uint32_t{1} << (BITS - 1 - k);
+    }
+    return v;
+  }
+  const Polynomial &p = TABLE[d - 1];
+  /* v[k] holds direction number k + 1 of the usual 1-based notation. */
+  for (std::size_t k = 0; k < BITS; k++) {
+    if (k < p.s) {
+      v[k] = p.m[k] << (BITS - 1 - k);
+      continue;
+    }
+    v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+    for (std::size_t j = 1; j < p.s; j++) {
+      if ((p.a >> (p.s - 1 - j)) & 1) {
+        v[k] ^= v[k - j];
+      }
+    }
+  }
+  return v;
+}
+
+inline void SobolSampler::Fill(uint64_t first, std::size_t count,
+                               double *out) const {
+  if (first > MAX_POINTS || count > MAX_POINTS - first) {
+    throw std::runtime_error("Sobol index out of range");
+  }
+  /* Point i is the XOR of the direction numbers of the bits of the Gray
+   * code of i. Consecutive Gray codes differ in the lowest set bit of
+   * i + 1, so after the first point each one takes a single XOR. */
+  const uint64_t gray = first ^ (first >> 1);
+  for (std::size_t d = 0; d < dimensions; d++) {
+    const Directions &v = directions[d];
+    uint32_t x = shift[d];
+    for (std::size_t k = 0; k < BITS; k++) {
+      if ((gray >> k) & 1) {
+        x ^= v[k];
+      }
+    }
+    double *row = out + d * count;
+    for (std::size_t i = 0; i < count; i++) {
+      row[i] = static_cast<double>(x) * 0x1p-32;
+      const uint64_t index = first + i + 1;
+      if (index < MAX_POINTS) {
+        x ^= v[std::countr_zero(index)];
+      }
+    }
+  }
+}
+
+inline HaltonSampler::HaltonSampler(std::size_t dimension, uint64_t seed)
+    : dimensions(dimension) {
+  sampling::check_dimension(dimension);
+  for (std::size_t d = 0; d < dimensions; d++) {
+    const uint32_t base = BASES[d];
+    auto &digit = permutation[d];
+    for (uint32_t i = 0; i < base; i++) {
+      digit[i] = static_cast<uint8_t>(i);
+    }
+    if (seed != 0) {
+      /* Fisher-Yates with a SplitMix64 stream per dimension. */
+      uint64_t state = sampling::mix64(seed ^ (uint64_t{d} << 32));
+      for (uint32_t i = base - 1; i > 0; i--) {
+        state = sampling::mix64(state);
+        std::swap(digit[i], digit[state % (i + 1)]);
+      }
+    }
+    /* A permuted zero digit adds to every later position, so the digits
+     * run until their weight base^-k drops below 2^-53. */
+    double weight = 1.0;
+    while (weight >= 0x1p-53) {
+      weight /= base;
+      digits[d]++;
+    }
+  }
+}
+
+inline double HaltonSampler::radical_inverse(std::size_t d,
+                                             uint64_t index) const {
+  const uint64_t base = BASES[d];
+  const auto &digit = permutation[d];
+  const double inverse_base = 1.0 / static_cast<double>(base);
+  double weight = inverse_base;
+  double x = 0.0;
+  for (uint32_t k = 0; k < digits[d]; k++) {
+    x += digit[index % base] * weight;
+    index /= base;
+    weight *= inverse_base;
+  }
+  /* Rounding may reach 1 for the largest digits. */
+  return std::min(x, 1.0 - 0x1p-53);
+}
+
+inline void HaltonSampler::Fill(uint64_t first, std::size_t count,
+                                double *out) const {
+  for (std::size_t d = 0; d < dimensions; d++) {
+    double *row = out + d * count;
+    for (std::size_t i = 0; i < count; i++) {
+      row[i] = radical_inverse(d, first + i);
+    }
+  }
+}
+
+inline LatinHypercubeSampler::LatinHypercubeSampler(std::size_t dimension,
+                                                    uint64_t points,
+                                                    uint64_t seed)
+    : dimensions(dimension), total(points), seed(seed),
+      mask(points <= 1 ? 0 : std::bit_ceil(points) - 1) {
+  sampling::check_dimension(dimension);
+  if (points == 0) {
+    throw std::runtime_error("Latin hypercube needs at least one point");
+  }
+}
+
+inline uint64_t LatinHypercubeSampler::stratum(std::size_t d,
+                                               uint64_t index) const {
+  /* Keyed bijection of [0, mask], applied until the result lands in
+   * [0, total). Each step is invertible modulo mask + 1: adding a key,
+   * multiplying by an odd number and xorshifting right. Fewer than half
+   * of the values are out of range, so this takes two rounds on average
+   * and permutes [0, total). */
+  const uint64_t key = sampling::mix64(seed ^ (uint64_t{d} << 40));
+  const uint64_t half = std::max<uint64_t>(1, std::bit_width(mask) / 2);
+  do {
+    for (uint64_t round = 0; round < 3; round++) {
+      index = (index + sampling::mix64(key + round)) & mask;
+      index = (index * ((key >> 1) | 1)) & mask;
+      index ^= index >> half;
+    }
+  } while (index >= total);
+  return index;
+}
+
+inline void LatinHypercubeSampler::Fill(uint64_t first, std::size_t count,
+                                        double *out) const {
+  if (first > total || count > total - first) {
+    throw std::runtime_error("Latin hypercube has only " +
+                             std::to_string(total) + " points");
+  }
+  const double width = 1.0 / static_cast<double>(total);
+  for (std::size_t d = 0; d < dimensions; d++) {
+    double *row = out + d * count;
+    for (std::size_t i = 0; i < count; i++) {
+      const uint64_t index = first + i;
+      const double offset = sampling::unit_interval(sampling::mix64(
+          seed ^ sampling::mix64(index * sampling::MAX_DIMENSION + d)));
+      row[i] = (static_cast<double>(stratum(d, index)) + offset) * width;
+    }
+  }
+}
+
+inline SamplerKind parse_sampler_kind(std::string_view name) {
+  if (name == "sobol") {
+    return SamplerKind::Sobol;
+  }
+  if (name == "halton") {
+    return SamplerKind::Halton;
+  }
+  if (name == "lhs") {
+    return SamplerKind::LatinHypercube;
+  }
+  throw std::runtime_error("Unknown sampler '" + std::string(name) +
+                           "', expected sobol, halton or lhs");
+}
+
+inline Sampler::Sampler(SamplerKind kind, std::size_t dimension,
+                        uint64_t points, uint64_t seed)
+    : sampler(SobolSampler(dimension, seed)) {
+  switch (kind) {
+  case SamplerKind::Sobol:
+    break;
+  case SamplerKind::Halton:
+    sampler = HaltonSampler(dimension, seed);
+    break;
+  case SamplerKind::LatinHypercube:
+    sampler = LatinHypercubeSampler(dimension, points, seed);
+    break;
+  }
+}
+
+inline std::size_t Sampler::dimension() const {
+  return std::visit([](const auto &s) { return s.dimension(); }, sampler);
+}
+
+inline void Sampler::Fill(uint64_t first, std::size_t count,
+                          double *out) const {
+  std::visit([&](const auto &s) { s.Fill(first, count, out); }, sampler);
+}
+
+template <std::size_t N>
+SamplePoints<N>::SamplePoints(const Sampler &sampler,
+                              const CMyVektor<N> &lower,
+                              const CMyVektor<N> &upper, uint64_t first,
+                              uint64_t count)
+    : sampler(sampler), lower(lower), extent(upper + (-1.0) * lower),
+      next_index(first), end(first + count) {
+  if (sampler.dimension() != N) {
+    throw std::runtime_error("Sampler dimension " +
+                             std::to_string(sampler.dimension()) +
+                             " does not match " + std::to_string(N));
+  }
+}
+
+template <std::size_t N> bool SamplePoints<N>::Next(CMyVektor<N> &x) {
+  if (position == block_size) {
+    if (next_index == end) {
+      return false;
+    }
+    block_size =
+        static_cast<std::size_t>(std::min<uint64_t>(sampling::BLOCK,
+                                                    end - next_index));
+    sampler.Fill(next_index, block_size, block.data());
+    next_index += block_size;
+    position = 0;
+    for (std::size_t d = 0; d < N; d++) {
+      double *row = block.data() + d * block_size;
+      for (std::size_t i = 0; i < block_size; i++) {
+        row[i] = lower[d] + extent[d] * row[i];
+      }
+    }
+  }
+  for (std::size_t d = 0; d < N; d++) {
+    x[d] = block[d * block_size + position];
+  }
+  position++;
+  return true;
+}
+
+template <std::size_t N>
+SampleEstimate<N> &
+SampleEstimate<N>::operator+=(const SampleEstimate<N> &other) {
+  samples += other.samples;
+  sum += other.sum;
+  if (other.maximum > maximum) {
+    maximum = other.maximum;
+    argmax = other.argmax;
+  }
+  return *this;
+}
+
+template <std::size_t N>
+SampleEstimate<N> Estimate(const Sampler &sampler, FunctionPtr<N> funktion,
+                           const CMyVektor<N> &lower,
+                           const CMyVektor<N> &upper, uint64_t first,
+                           uint64_t count) {
+  SamplePoints<N> points(sampler, lower, upper, first, count);
+  SampleEstimate<N> estimate{};
+  CMyVektor<N> x{};
+  while (points.Next(x)) {
+    const double value = evaluate(funktion, x);
+    estimate.samples++;
+    estimate.sum += value;
+    if (value > estimate.maximum) {
+      estimate.maximum = value;
+      estimate.argmax = x;
+    }
+  }
+  return estimate;
+}
+
+#endif // SAMPLER_H_
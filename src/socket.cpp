@@ -0,0 +1,210 @@
+/**
+ * @file socket.cpp
+ *
+ * @brief POSIX implementation of `Socket`.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "socket.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+[[noreturn]] void throw_errno(const std::string &what) {
+  throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+/** Split `tcp:<host>:<port>` into host and port. */
+auto split_tcp(std::string_view address)
+    -> std::pair<std::string, std::string> {
+  const auto colon = address.rfind(':');
+  if (colon == std::string_view::npos) {
+    throw std::runtime_error("TCP endpoint needs a port: '" +
+                             std::string(address) + "'");
+  }
+  return {std::string(address.substr(0, colon)),
+          std::string(address.substr(colon + 1))};
+}
+
+auto unix_address(const std::string &path) -> sockaddr_un {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    throw std::runtime_error("Socket path too long: '" + path + "'");
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  return addr;
+}
+
+/** Open a TCP socket bound (`listen`) or connected to `address`. */
+auto open_tcp(std::string_view address, bool listen) -> Socket {
+  auto [host, port] = split_tcp(address);
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = listen ? AI_PASSIVE : 0;
+  addrinfo *result = nullptr;
+  const char *node = (listen && (host.empty() || host == "*")) ? nullptr
+                                                               : host.c_str();
+  if (const int err = getaddrinfo(node, port.c_str(), &hints, &result);
+      err != 0) {
+    throw std::runtime_error("Could not resolve '" + std::string(address) +
+                             "': " + gai_strerror(err));
+  }
+
+  Socket ret{};
+  for (addrinfo *ai = result; ai != nullptr; ai = ai->ai_next) {
+    Socket candidate(::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol));
+    if (!candidate.valid()) {
+      continue;
+    }
+    const int one = 1;
+    if (listen) {
+      setsockopt(candidate.native(), SOL_SOCKET, SO_REUSEADDR, &one,
+                 sizeof(one));
+      if (::bind(candidate.native(), ai->ai_addr, ai->ai_addrlen) == 0 &&
+          ::listen(candidate.native(), SOMAXCONN) == 0) {
+        ret = std::move(candidate);
+        break;
+      }
+    } else if (::connect(candidate.native(), ai->ai_addr, ai->ai_addrlen) ==
+               0) {
+      /* Records are small and latency matters more than throughput. */
+      setsockopt(candidate.native(), IPPROTO_TCP, TCP_NODELAY, &one,
+                 sizeof(one));
+      ret = std::move(candidate);
+      break;
+    }
+  }
+  freeaddrinfo(result);
+  if (!ret.valid()) {
+    throw_errno("Could not open '" + std::string(address) + "'");
+  }
+  return ret;
+}
+} // namespace
+
+Socket::~Socket() {
+  if (fd >= 0) {
+    ::close(fd);
+  }
+}
+
+Socket::Socket(Socket &&other) noexcept : fd(other.fd) { other.fd = -1; }
+
+Socket &Socket::operator=(Socket &&other) noexcept {
+  if (this != &other) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    fd = other.fd;
+    other.fd = -1;
+  }
+  return *this;
+}
+
+Socket Socket::Listen(const std::string &endpoint) {
+  const std::string_view view = endpoint;
+  if (view.starts_with("tcp:")) {
+    return open_tcp(view.substr(4), true);
+  }
+  const std::string path =
+      view.starts_with("unix:") ? endpoint.substr(5) : endpoint;
+  const sockaddr_un addr = unix_address(path);
+  Socket ret(::socket(AF_UNIX, SOCK_STREAM, 0));
+  if (!ret.valid()) {
+    throw_errno("Could not create socket");
+  }
+  ::unlink(path.c_str());
+  if (::bind(ret.fd, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) !=
+          0 ||
+      ::listen(ret.fd, SOMAXCONN) != 0) {
+    throw_errno("Could not listen on '" + path + "'");
+  }
+  return ret;
+}
+
+Socket Socket::Connect(const std::string &endpoint) {
+  const std::string_view view = endpoint;
+  if (view.starts_with("tcp:")) {
+    return open_tcp(view.substr(4), false);
+  }
+  const std::string path =
+      view.starts_with("unix:") ? endpoint.substr(5) : endpoint;
+  const sockaddr_un addr = unix_address(path);
+  Socket ret(::socket(AF_UNIX, SOCK_STREAM, 0));
+  if (!ret.valid()) {
+    throw_errno("Could not create socket");
+  }
+  if (::connect(ret.fd, reinterpret_cast<const sockaddr *>(&addr),
+                sizeof(addr)) != 0) {
+    throw_errno("Could not connect to '" + path + "'");
+  }
+  return ret;
+}
+
+Socket Socket::Accept() const {
+  while (true) {
+    const int client = ::accept(fd, nullptr, nullptr);
+    if (client >= 0) {
+      return Socket(client);
+    }
+    if (errno != EINTR) {
+      throw_errno("Could not accept connection");
+    }
+  }
+}
+
+void Socket::WriteAll(const void *data, std::size_t size) const {
+  const auto *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    /* MSG_NOSIGNAL: A vanished peer is an error, not a reason to die. */
+    const ssize_t written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_errno("Could not write to socket");
+    }
+    bytes += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+bool Socket::ReadExact(void *data, std::size_t size) const {
+  auto *bytes = static_cast<char *>(data);
+  std::size_t done = 0;
+  while (done < size) {
+    const ssize_t got = ::recv(fd, bytes + done, size - done, 0);
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_errno("Could not read from socket");
+    }
+    if (got == 0) {
+      if (done == 0) {
+        return false;
+      }
+      throw std::runtime_error("Connection closed in the middle of a message");
+    }
+    done += static_cast<std::size_t>(got);
+  }
+  return true;
+}
+
+void Socket::Shutdown() const {
+  if (fd >= 0) {
+    ::shutdown(fd, SHUT_RDWR);
+  }
+}
@@ -0,0 +1,67 @@
+#ifndef SOCKET_H_
+#define SOCKET_H_
+/**
+ * @file socket.hpp
+ *
+ * @brief Minimal blocking stream socket for Unix-domain and TCP connections.
+ *
+ * Endpoints are given as strings:
+ *
+ * - `unix:<path>` or a plain path: Unix-domain socket.
+ * - `tcp:<host>:<port>`: TCP socket. Listening on `tcp:*:<port>` binds all
+ *   interfaces.
+ *
+ * All functions throw `std::runtime_error` on failure.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <cstddef>
+#include <string>
+
+/** Owning wrapper around a connected or listening socket file descriptor. */
+class Socket {
+public:
+  Socket() = default;
+  explicit Socket(int fd) : fd(fd) {}
+  ~Socket();
+
+  Socket(const Socket &) = delete;
+  Socket &operator=(const Socket &) = delete;
+  Socket(Socket &&other) noexcept;
+  Socket &operator=(Socket &&other) noexcept;
+
+  /** Create a socket listening on `endpoint`. An existing Unix-domain socket
+   * file is replaced. */
+  [[nodiscard]] static Socket Listen(const std::string &endpoint);
+
+  /** Connect to `endpoint`. */
+  [[nodiscard]] static Socket Connect(const std::string &endpoint);
+
+  /** Wait for and accept the next connection of a listening socket. */
+  [[nodiscard]] Socket Accept() const;
+
+  /** Write all `size` bytes. */
+  void WriteAll(const void *data, std::size_t size) const;
+
+  /**
+   * Read exactly `size` bytes.
+   *
+   * @returns 'false' if the peer closed the connection before the first byte.
+   */
+  [[nodiscard]] bool ReadExact(void *data, std::size_t size) const;
+
+  /** Shut down both directions, e.g. to wake a thread blocked in a read. */
+  void Shutdown() const;
+
+  /** Returns 'true' if the socket holds a file descriptor. */
+  [[nodiscard]] bool valid() const { return fd >= 0; }
+
+  /** Underlying file descriptor. */
+  [[nodiscard]] int native() const { return fd; }
+
+private:
+  int fd{-1};
+};
+
+#endif // SOCKET_H_
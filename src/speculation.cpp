@@ -0,0 +1,135 @@
+/**
+ * @file speculation.cpp
+ *
+ * @brief Implementation of the speculative run precomputation.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "speculation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Speculation::Speculation(FunctionPtr<2> funktion, double step_size)
+    : funktion(funktion), step_size(step_size) {}
+
+Speculation::~Speculation() {
+  for (auto &job : jobs) {
+    *job.cancelled = true;
+  }
+}
+
+bool Speculation::same(const CMyVektor<2> &a, const CMyVektor<2> &b) {
+  return std::abs(a[0] - b[0]) < TOLERANCE &&
+         std::abs(a[1] - b[1]) < TOLERANCE;
+}
+
+void Speculation::collect() {
+  std::vector<std::unique_ptr<Run>> finished;
+  {
+    const std::lock_guard lock(shared->mutex);
+    finished.swap(shared->finished);
+  }
+  for (auto &run : finished) {
+    std::erase_if(jobs, [&](const Job &job) {
+      return same(job.start, run->start) &&
+             job.max_iterations == run->max_iterations;
+    });
+    if (runs.size() == MAX_RUNS) {
+      runs.erase(runs.begin());
+    }
+    runs.push_back(std::move(run));
+  }
+}
+
+void Speculation::Request(const CMyVektor<2> &start, double spacing,
+                          std::size_t max_iterations) {
+  collect();
+  const CMyVektor<2> candidates[] = {
+      start,
+      CMyVektor<2>{start[0] + spacing, start[1]},
+      CMyVektor<2>{start[0] - spacing, start[1]},
+      CMyVektor<2>{start[0], start[1] + spacing},
+      CMyVektor<2>{start[0], start[1] - spacing},
+  };
+  const auto is_candidate = [&](const CMyVektor<2> &point,
+                                std::size_t limit) {
+    return limit == max_iterations &&
+           std::any_of(std::begin(candidates), std::end(candidates),
+                       [&](const auto &c) { return same(c, point); });
+  };
+
+  std::erase_if(jobs, [&](const Job &job) {
+    if (is_candidate(job.start, job.max_iterations)) {
+      return false;
+    }
+    *job.cancelled = true;
+    return true;
+  });
+
+  for (const auto &candidate : candidates) {
+    const auto matches = [&](const auto &other) {
+      return same(other.start, candidate) &&
+             other.max_iterations == max_iterations;
+    };
+    if (std::any_of(jobs.begin(), jobs.end(), matches) ||
+        std::any_of(runs.begin(), runs.end(),
+                    [&](const auto &run) { return matches(*run); })) {
+      continue;
+    }
+
+    Job &job = jobs.emplace_back();
+    job.start = candidate;
+    job.max_iterations = max_iterations;
+    job.cancelled = std::make_shared<std::atomic<bool>>(false);
+    pool.Submit([shared = shared, cancelled = job.cancelled, start = candidate,
+                 max_iterations, funktion = funktion,
+                 step_size = step_size] {
+      if (*cancelled) {
+        return;
+      }
+      auto run = std::make_unique<Run>();
+      run->start = start;
+      run->max_iterations = max_iterations;
+      run->trajectory = Trajectory<2>::Record(
+          IterationData<2>::AtPoint(start, funktion, step_size, 0),
+          max_iterations, cancelled.get());
+      if (*cancelled) {
+        return;
+      }
+
+      /* Sample the path here, so drawing it costs nothing. Seeking forward
+       * continues from the previous sample. */
+      const std::size_t size = run->trajectory.size();
+      const std::size_t stride = std::max<std::size_t>(
+          1, (size + MAX_PATH_POINTS - 1) / MAX_PATH_POINTS);
+      for (std::size_t i = 0; i < size; i += stride) {
+        const auto &point = run->trajectory.At(i).current.vector;
+        run->path_x.push_back(point[0]);
+        run->path_y.push_back(point[1]);
+      }
+      if ((size - 1) % stride != 0) {
+        const auto &end = run->trajectory.back().current.vector;
+        run->path_x.push_back(end[0]);
+        run->path_y.push_back(end[1]);
+      }
+
+      const std::lock_guard lock(shared->mutex);
+      shared->finished.push_back(std::move(run));
+    });
+  }
+}
+
+Speculation::Run *Speculation::Lookup(const CMyVektor<2> &start,
+                                      std::size_t max_iterations) {
+  collect();
+  for (auto it = runs.begin(); it != runs.end(); ++it) {
+    if (same((*it)->start, start) && (*it)->max_iterations == max_iterations) {
+      /* Most recently used last. */
+      std::rotate(it, it + 1, runs.end());
+      return runs.back().get();
+    }
+  }
+  return nullptr;
+}
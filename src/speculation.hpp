@@ -0,0 +1,106 @@
+#ifndef SPECULATION_H_
+#define SPECULATION_H_
+/**
+ * @file speculation.hpp
+ *
+ * @brief Background precomputation of runs for start points the user is
+ * about to choose.
+ *
+ * While the start point is dragged, `Request()` is called with the current
+ * start every frame. The run from there and from the neighbours one drag
+ * step away in each direction are recorded on worker threads, so the
+ * predicted path is ready when the drag gets there. Jobs for points that
+ * are no longer a candidate are cancelled. Finished runs are kept in a small
+ * cache and can be handed to the model when the calculation is started.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include "thread_pool.hpp"
+#include "trajectory.hpp"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/** Speculatively recorded runs around the current start point. */
+class Speculation {
+public:
+  /** A finished run with its path sampled for drawing. */
+  struct Run {
+    CMyVektor<2> start{};
+    std::size_t max_iterations{};
+    Trajectory<2> trajectory{};
+    std::vector<double> path_x{};
+    std::vector<double> path_y{};
+  };
+
+  /** Worker threads. Separate from other background work, so the predicted
+   * path does not wait for e.g. a basin map. */
+  static constexpr std::size_t THREADS = 2;
+
+  /** Number of finished runs kept. */
+  static constexpr std::size_t MAX_RUNS = 16;
+
+  /** Maximum number of path samples per run. */
+  static constexpr std::size_t MAX_PATH_POINTS = 1024;
+
+  /** Start points closer than this in every coordinate are the same. */
+  static constexpr double TOLERANCE = 1.0e-9;
+
+  Speculation(FunctionPtr<2> funktion, double step_size);
+
+  /** Cancels all jobs. */
+  ~Speculation();
+
+  Speculation(const Speculation &) = delete;
+  Speculation &operator=(const Speculation &) = delete;
+
+  /**
+   * Record runs from `start` and from `start` moved by `spacing` along each
+   * axis, unless they are cached or being recorded already. Cancels jobs for
+   * all other start points.
+   */
+  void Request(const CMyVektor<2> &start, double spacing,
+               std::size_t max_iterations);
+
+  /** Finished run from `start`, `nullptr` if there is none (yet). Valid
+   * until the next call of any method. */
+  [[nodiscard]] Run *Lookup(const CMyVektor<2> &start,
+                            std::size_t max_iterations);
+
+private:
+  /** A run being recorded. */
+  struct Job {
+    CMyVektor<2> start{};
+    std::size_t max_iterations{};
+    std::shared_ptr<std::atomic<bool>> cancelled{};
+  };
+
+  /** State shared with the workers. */
+  struct Shared {
+    std::mutex mutex{};
+    /** Runs finished but not yet collected. */
+    std::vector<std::unique_ptr<Run>> finished{};
+  };
+
+  FunctionPtr<2> funktion;
+  double step_size;
+
+  std::shared_ptr<Shared> shared{std::make_shared<Shared>()};
+  std::vector<Job> jobs{};
+  /** Finished runs, least recently used first. */
+  std::vector<std::unique_ptr<Run>> runs{};
+
+  /** Declared last, so workers are joined before anything else goes. */
+  ThreadPool pool{THREADS};
+
+  /** Move finished runs from the workers into `runs`. */
+  void collect();
+
+  static bool same(const CMyVektor<2> &a, const CMyVektor<2> &b);
+};
+
+#endif // SPECULATION_H_
@@ -0,0 +1,83 @@
+#ifndef STENCIL_CACHE_H_
+#define STENCIL_CACHE_H_
+/**
+ * @file stencil_cache.hpp
+ *
+ * @brief Evaluate an objective a gradient stencil at a time.
+ *
+ * For objectives where one call with many points costs about as much as one
+ * with a single point, e.g. callbacks into other languages or other
+ * processes. On a miss at x the cache asks for x and x + H e_i for all i in
+ * one call and keeps the last `STENCILS` stencils. `IterationData::AtPoint`
+ * evaluates x and then exactly these points, and the next iteration starts
+ * at a point evaluated before, so every iteration takes two calls instead
+ * of `2 * N + 3`.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+/** The last few gradient stencils of an objective and their values. */
+template <std::size_t N> class StencilCache {
+public:
+  static constexpr std::size_t STENCILS = 3;
+  static constexpr std::size_t POINTS = N + 1;
+
+  /**
+   * Value at `x`. On a miss `evaluate(points, values)` is called once with
+   * the `POINTS` points of the stencil at `x`, contiguous as `POINTS * N`
+   * doubles, and must store their values in `values[0 .. POINTS)`.
+   */
+  template <typename Evaluate>
+  double Get(const CMyVektor<N> &x, Evaluate &&evaluate);
+
+  /** Forget all stencils, e.g. when the objective changes. */
+  void Clear() {
+    filled = 0;
+    oldest = 0;
+  }
+
+private:
+  std::array<std::array<CMyVektor<N>, POINTS>, STENCILS> points{};
+  std::array<std::array<double, POINTS>, STENCILS> values{};
+  std::size_t filled{0};
+  /** Stencil replaced on the next miss. */
+  std::size_t oldest{0};
+};
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+
+template <std::size_t N>
+template <typename Evaluate>
+double StencilCache<N>::Get(const CMyVektor<N> &x, Evaluate &&evaluate) {
+  for (std::size_t s = 0; s < filled; s++) {
+    for (std::size_t p = 0; p < POINTS; p++) {
+      if (points[s][p] == x) {
+        return values[s][p];
+      }
+    }
+  }
+
+  /* Same arithmetic as `CMyVektor::gradient`, so its lookups match
+   * exactly. */
+  const std::size_t slot = oldest;
+  auto &stencil = points[slot];
+  stencil[0] = x;
+  for (std::size_t i = 0; i < N; i++) {
+    stencil[i + 1] = x;
+    stencil[i + 1][i] += CMyVektor<N>::H;
+  }
+  /* CMyVektor is a std::array of doubles, so the stencil is contiguous. */
+  static_assert(sizeof(CMyVektor<N>) == N * sizeof(double));
+  evaluate(static_cast<const double *>(stencil[0].data()),
+           values[slot].data());
+  filled = std::max(filled, slot + 1);
+  oldest = (slot + 1) % STENCILS;
+  return values[slot][0];
+}
+
+#endif // STENCIL_CACHE_H_
@@ -0,0 +1,58 @@
+/**
+ * @file thread_pool.cpp
+ *
+ * @brief Implementation of the thread pool.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "thread_pool.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  workers.reserve(threads);
+  for (std::size_t i = 0; i < threads; i++) {
+    workers.emplace_back(&ThreadPool::run, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard lock(mutex);
+    stop = true;
+    tasks.clear();
+  }
+  wake.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  {
+    const std::lock_guard lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+  wake.notify_one();
+}
+
+void ThreadPool::run() {
+  TRACE_THREAD_NAME("ThreadPool worker");
+  std::unique_lock lock(mutex);
+  while (true) {
+    wake.wait(lock, [this] { return stop || !tasks.empty(); });
+    if (stop) {
+      return;
+    }
+    auto task = std::move(tasks.front());
+    tasks.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
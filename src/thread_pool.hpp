@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+/**
+ * @file thread_pool.hpp
+ *
+ * @brief Fixed set of worker threads executing submitted tasks in order.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Worker threads that execute tasks in submission order. */
+class ThreadPool {
+public:
+  /** Start `threads` workers. Zero means one per hardware thread. */
+  explicit ThreadPool(std::size_t threads = 0);
+
+  /** Drops tasks that have not started and waits for running ones. */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /** Queue `task` for execution on one of the workers. */
+  void Submit(std::function<void()> task);
+
+  /** Number of worker threads. */
+  [[nodiscard]] std::size_t size() const { return workers.size(); }
+
+private:
+  std::mutex mutex{};
+  std::condition_variable wake{};
+  /** Protected by `mutex`. */
+  std::deque<std::function<void()>> tasks{};
+  bool stop{false};
+
+  std::vector<std::thread> workers{};
+
+  void run();
+};
+
+#endif // THREAD_POOL_H_
@@ -0,0 +1,163 @@
+/**
+ * @file trace.cpp
+ *
+ * @brief Per-thread event buffers and the Chrome trace writer.
+ *
+ * Only built with tracing enabled, see trace.hpp.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "trace.hpp"
+#include "alloc_counter.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+/** Events per thread buffer before it is handed to the registry. */
+constexpr std::size_t CHUNK_SIZE = 4096;
+
+/** Events kept in total. Later ones are counted but dropped, so a long run
+ * at detail level cannot exhaust memory. */
+constexpr std::size_t MAX_EVENTS = std::size_t{1} << 23;
+
+constexpr const char *DEFAULT_FILE = "plottings-trace.json";
+
+struct Event {
+  const char *name;
+  int64_t start;
+  int64_t duration;
+  uint32_t thread;
+};
+
+/** Events handed in by all threads. Writes the file when destroyed, after
+ * all threads have finished and flushed their buffers. */
+class Registry {
+public:
+  Registry() {
+    const char *path = std::getenv("PLOTTINGS_TRACE_FILE");
+    this->path = path != nullptr ? path : DEFAULT_FILE;
+  }
+
+  ~Registry() { Write(); }
+
+  Registry(const Registry &) = delete;
+  Registry &operator=(const Registry &) = delete;
+
+  uint32_t Register() {
+    const std::lock_guard lock(mutex);
+    return next_thread++;
+  }
+
+  void Name(uint32_t thread, const char *name) {
+    const std::lock_guard lock(mutex);
+    names.emplace_back(thread, name);
+  }
+
+  void Add(const std::vector<Event> &chunk) {
+    const std::lock_guard lock(mutex);
+    const std::size_t room = MAX_EVENTS - std::min(MAX_EVENTS, events.size());
+    const std::size_t taken = std::min(room, chunk.size());
+    events.insert(events.end(), chunk.begin(), chunk.begin() + taken);
+    dropped += chunk.size() - taken;
+  }
+
+private:
+  std::mutex mutex{};
+  std::string path;
+  uint32_t next_thread{0};
+  std::vector<std::pair<uint32_t, const char *>> names{};
+  std::vector<Event> events{};
+  std::size_t dropped{0};
+
+  void Write() {
+    const std::unique_ptr<std::FILE, decltype(&std::fclose)> file(
+        std::fopen(path.c_str(), "w"), &std::fclose);
+    if (!file) {
+      std::fprintf(stderr, "Could not write trace '%s'\n", path.c_str());
+      return;
+    }
+    std::fprintf(file.get(),
+                 "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+    const char *separator = "\n";
+    for (const auto &[thread, name] : names) {
+      std::fprintf(file.get(),
+                   "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                   "\"tid\": %u, \"args\": {\"name\": \"%s\"}}",
+                   separator, thread, name);
+      separator = ",\n";
+    }
+    /* Timestamps are in microseconds. */
+    for (const Event &event : events) {
+      std::fprintf(file.get(),
+                   "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                   "%u, \"ts\": %.3f, \"dur\": %.3f}",
+                   separator, event.name, event.thread,
+                   static_cast<double>(event.start) / 1e3,
+                   static_cast<double>(event.duration) / 1e3);
+      separator = ",\n";
+    }
+    std::fprintf(file.get(), "\n], \"otherData\": {\"dropped_events\": %zu}}\n",
+                 dropped);
+    if (dropped > 0) {
+      std::fprintf(stderr, "Trace: dropped %zu events beyond %zu\n", dropped,
+                   MAX_EVENTS);
+    }
+  }
+};
+
+Registry &registry() {
+  static Registry registry{};
+  return registry;
+}
+
+/** Events of one thread. Hands its rest to the registry at thread exit. */
+struct ThreadBuffer {
+  uint32_t thread{registry().Register()};
+  std::vector<Event> events{};
+
+  ThreadBuffer() { events.reserve(CHUNK_SIZE); }
+  ~ThreadBuffer() { registry().Add(events); }
+
+  ThreadBuffer(const ThreadBuffer &) = delete;
+  ThreadBuffer &operator=(const ThreadBuffer &) = delete;
+};
+
+ThreadBuffer &thread_buffer() {
+  thread_local ThreadBuffer buffer{};
+  return buffer;
+}
+
+const auto epoch = std::chrono::steady_clock::now();
+} // namespace
+
+namespace trace {
+int64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+void Record(const char *name, int64_t start, int64_t end) {
+  /* The buffers grow inside allocation-free scopes of the traced code. */
+  ALLOC_UNCOUNTED_SCOPE();
+  ThreadBuffer &buffer = thread_buffer();
+  buffer.events.push_back(Event{name, start, end - start, buffer.thread});
+  if (buffer.events.size() == CHUNK_SIZE) {
+    registry().Add(buffer.events);
+    buffer.events.clear();
+  }
+}
+
+void SetThreadName(const char *name) {
+  ALLOC_UNCOUNTED_SCOPE();
+  registry().Name(thread_buffer().thread, name);
+}
+} // namespace trace
@@ -0,0 +1,88 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+/**
+ * @file trace.hpp
+ *
+ * @brief Scoped trace events in the Chrome trace format.
+ *
+ * Tracing is compiled in with `-DPLOTTINGS_TRACE=1` (or `=2`, see below),
+ * e.g. through the CMake cache variable of the same name. Otherwise all
+ * macros expand to nothing and trace.cpp is not built.
+ *
+ * - `TRACE_SCOPE(name)` records the time until the end of the enclosing
+ * block.
+ * - `TRACE_STAGE_BEGIN(name)` and `TRACE_STAGE(name)` split one function
+ * into consecutive stages without extra blocks: each `TRACE_STAGE` ends the
+ * previous stage and starts the next one.
+ * - `TRACE_THREAD_NAME(name)` names the calling thread in the viewer.
+ * - `TRACE_DETAIL_SCOPE(name)` is for very frequent events such as single
+ * objective evaluations and only recorded with `PLOTTINGS_TRACE=2`.
+ *
+ * Names must be string literals that need no JSON escaping. Each thread
+ * appends to its own buffer without locking and hands full chunks to a
+ * global list. At process exit the events are written to the file in
+ * `PLOTTINGS_TRACE_FILE` (default "plottings-trace.json"), which loads in
+ * chrome://tracing and Perfetto. Threads still running at that point lose
+ * their last partial chunk.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+
+#if defined(PLOTTINGS_TRACE) && PLOTTINGS_TRACE > 0
+#include <cstdint>
+
+namespace trace {
+/** Nanoseconds since the first trace call of the process. */
+[[nodiscard]] int64_t now();
+
+/** Append a complete event of the calling thread. */
+void Record(const char *name, int64_t start, int64_t end);
+
+/** Name the calling thread. */
+void SetThreadName(const char *name);
+
+/** Records the time from construction to destruction or to `Next`. */
+class Scope {
+public:
+  explicit Scope(const char *name) : name(name), start(now()) {}
+  ~Scope() { Record(name, start, now()); }
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+  /** End the current event and start one called `next_name`. */
+  void Next(const char *next_name) {
+    const int64_t time = now();
+    Record(name, start, time);
+    name = next_name;
+    start = time;
+  }
+
+private:
+  const char *name;
+  int64_t start;
+};
+} // namespace trace
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name)                                                      \
+  const trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_STAGE_BEGIN(name) trace::Scope trace_stage(name)
+#define TRACE_STAGE(name) trace_stage.Next(name)
+#define TRACE_THREAD_NAME(name) trace::SetThreadName(name)
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_STAGE_BEGIN(name) static_cast<void>(0)
+#define TRACE_STAGE(name) static_cast<void>(0)
+#define TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+#if defined(PLOTTINGS_TRACE) && PLOTTINGS_TRACE > 1
+#define TRACE_DETAIL_SCOPE(name) TRACE_SCOPE(name)
+#else
+#define TRACE_DETAIL_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif // TRACE_H_
@@ -0,0 +1,166 @@
+#ifndef TRAJECTORY_H_
+#define TRAJECTORY_H_
+/**
+ * @file trajectory.hpp
+ *
+ * @brief Recorded gradient descent run with random access to any iteration.
+ *
+ * Showing iteration k by replaying k steps from the start gets expensive for
+ * long runs. A `Trajectory` runs the optimization once and keeps every
+ * iteration as long as the run is short. Longer runs are thinned out to
+ * checkpoints at every `stride()`-th iteration, so memory stays bounded and
+ * seeking replays at most `stride() - 1` steps from the nearest checkpoint.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "iteration.hpp"
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Recorded gradient descent iterations.
+ *
+ * Positions are counted from the first recorded iteration, i.e. position 0 is
+ * the iteration the trajectory was recorded from.
+ *
+ * @tparam N Dimension of function pre-image.
+ */
+template <std::size_t N> class Trajectory {
+public:
+  /** Maximum number of stored checkpoints. If a run gets longer, every second
+   * checkpoint is dropped and the stride doubles. */
+  static constexpr std::size_t MAX_CHECKPOINTS = 1 << 14;
+
+  Trajectory() = default;
+
+  /**
+   * Run gradient descent from `init` until it is done and record it.
+   *
+   * @param init First iteration, e.g. from `IterationData::AtPoint`.
+   * @param max_iterations Iteration limit passed to `IterationData::done`.
+   * @param cancelled If set, recording stops early once it becomes 'true'.
+   * The result is incomplete then.
+   */
+  [[nodiscard]] static Trajectory
+  Record(const IterationData<N> &init,
+         std::size_t max_iterations = IterationData<N>::MAX_ITERATIONS,
+         const std::atomic<bool> *cancelled = nullptr);
+
+  /** Number of recorded iterations including the first and the last one. */
+  [[nodiscard]] std::size_t size() const {
+    return empty() ? 0 : last.index - checkpoints.front().index + 1;
+  }
+
+  /** Returns 'true' if nothing has been recorded yet. */
+  [[nodiscard]] bool empty() const { return checkpoints.empty(); }
+
+  /** Distance between two stored checkpoints. One if every iteration is
+   * stored. */
+  [[nodiscard]] std::size_t stride() const { return stride_; }
+
+  /** Last recorded iteration. This is the optimum if the run converged. */
+  [[nodiscard]] const IterationData<N> &back() const { return last; }
+
+  /**
+   * Iteration at `position`. Positions past the end are clamped to the last
+   * iteration.
+   *
+   * Seeking forward from the previous result continues from there instead of
+   * the checkpoint, so dragging a slider costs at most a few steps per frame.
+   * The returned reference is valid until the next call. Not thread-safe.
+   */
+  [[nodiscard]] const IterationData<N> &At(std::size_t position) const;
+
+private:
+  /** Stored iterations. `checkpoints[i]` is at position `i * stride_`. */
+  std::vector<IterationData<N>> checkpoints{};
+
+  /** Distance between two checkpoints. Always a power of two. */
+  std::size_t stride_{1};
+
+  /** Last recorded iteration. */
+  IterationData<N> last{};
+
+  /** Result of the previous `At()` call. */
+  mutable IterationData<N> cursor{};
+
+  /** Position of `cursor`. Invalid if `cursor_valid` is 'false'. */
+  mutable std::size_t cursor_position{0};
+  mutable bool cursor_valid{false};
+
+  /** Drop every second checkpoint and double the stride. */
+  void thin_out();
+};
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+template <std::size_t N>
+Trajectory<N> Trajectory<N>::Record(const IterationData<N> &init,
+                                    std::size_t max_iterations,
+                                    const std::atomic<bool> *cancelled) {
+  Trajectory<N> ret{};
+  /* A run has at most `max_iterations + 1` iterations, short runs need not
+   * reserve all checkpoints. */
+  ret.checkpoints.reserve(max_iterations < MAX_CHECKPOINTS
+                              ? max_iterations + 1
+                              : MAX_CHECKPOINTS);
+
+  IterationData<N> iteration = init;
+  std::size_t position = 0;
+  while (true) {
+    if (position % ret.stride_ == 0) {
+      if (ret.checkpoints.size() == MAX_CHECKPOINTS) {
+        ret.thin_out();
+      }
+      /* Thinning may have made this position a non-checkpoint. */
+      if (position % ret.stride_ == 0) {
+        ret.checkpoints.push_back(iteration);
+      }
+    }
+    if (iteration.done(max_iterations) ||
+        (cancelled != nullptr && *cancelled)) {
+      break;
+    }
+    iteration = IterationData<N>::Next(iteration);
+    position++;
+  }
+  ret.last = iteration;
+  return ret;
+}
+
+template <std::size_t N> void Trajectory<N>::thin_out() {
+  const std::size_t kept = (checkpoints.size() + 1) / 2;
+  for (std::size_t i = 1; i < kept; i++) {
+    checkpoints[i] = checkpoints[2 * i];
+  }
+  checkpoints.resize(kept);
+  stride_ *= 2;
+}
+
+template <std::size_t N>
+const IterationData<N> &Trajectory<N>::At(std::size_t position) const {
+  if (position + 1 >= size()) {
+    return last;
+  }
+  const std::size_t base = position / stride_;
+  if (stride_ == 1) {
+    return checkpoints[base];
+  }
+
+  /* Continue from the previous seek if it lies between checkpoint and
+   * target, otherwise restart at the checkpoint. */
+  if (!cursor_valid || cursor_position > position ||
+      cursor_position < base * stride_) {
+    cursor = checkpoints[base];
+    cursor_position = base * stride_;
+    cursor_valid = true;
+  }
+  while (cursor_position < position) {
+    cursor = IterationData<N>::Next(cursor);
+    cursor_position++;
+  }
+  return cursor;
+}
+
+#endif // TRAJECTORY_H_
@@ -7,22 +7,129 @@
  * @date 03-05-2024
  */
 #include "ui.hpp"
+#include "alloc_counter.hpp"
 #include "cmyvektor.hpp"
+#include "eval_profile.hpp"
 #include "functions.hpp"
 #include "imgui.h"
 #include "iteration.hpp"
+#include "protocol.hpp"
+#include "trace.hpp"
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <implot.h>
 
-#include <sstream>
+#include <algorithm>
+#include <iterator>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+#if defined(PLOTTINGS_EVAL_PROFILE) && PLOTTINGS_EVAL_PROFILE > 0
+/** Table of the objective evaluations of all threads since the last reset. */
+void ShowEvalProfile() {
+  if (!ImGui::CollapsingHeader("Objective evaluations")) {
+    return;
+  }
+  if (ImGui::Button("Reset counters")) {
+    eval_profile::Reset();
+  }
+  const eval_profile::Summary summary = eval_profile::Collect();
+  if (ImGui::BeginTable("evaluations", 5, ImGuiTableFlags_Borders)) {
+    for (const char *header :
+         {"Site", "Calls", "Mean [ns]", "p50 [ns]", "p99 [ns]"}) {
+      ImGui::TableSetupColumn(header);
+    }
+    ImGui::TableHeadersRow();
+    for (std::size_t s = 0; s < eval_profile::SITES; s++) {
+      const eval_profile::SiteTotals &site = summary.sites[s];
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(eval_profile::SITE_NAMES[s]);
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", static_cast<unsigned long long>(site.calls));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.0f", site.mean_nanoseconds());
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", static_cast<unsigned long long>(
+                              site.quantile_nanoseconds(0.5)));
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", static_cast<unsigned long long>(
+                              site.quantile_nanoseconds(0.99)));
+    }
+    ImGui::EndTable();
+  }
+}
+#endif
+
+/** Draw `heatmap` with ImPlot in its native element type. */
+void PlotHeatmap(const char *label, const Heatmap &heatmap) {
+  const int rows = static_cast<int>(heatmap.resolution());
+  const ImPlotPoint bounds_min(heatmap.x_min(), heatmap.y_min());
+  const ImPlotPoint bounds_max(heatmap.x_min() + heatmap.size(),
+                               heatmap.y_min() + heatmap.size());
+  switch (heatmap.precision()) {
+  case HeatmapPrecision::Float64:
+    ImPlot::PlotHeatmap(label, static_cast<const double *>(heatmap.data()),
+                        rows, rows, heatmap.min(), heatmap.max(), "",
+                        bounds_min, bounds_max, ImPlotHeatmapFlags_None);
+    break;
+  case HeatmapPrecision::Float32:
+    ImPlot::PlotHeatmap(label, static_cast<const float *>(heatmap.data()),
+                        rows, rows, heatmap.min(), heatmap.max(), "",
+                        bounds_min, bounds_max, ImPlotHeatmapFlags_None);
+    break;
+  case HeatmapPrecision::UNorm16:
+    /* Quantized values span the full 16-bit range. */
+    ImPlot::PlotHeatmap(label, static_cast<const ImU16 *>(heatmap.data()),
+                        rows, rows, 0.0, 65535.0, "", bounds_min, bounds_max,
+                        ImPlotHeatmapFlags_None);
+    break;
+  }
+}
+
+/** Draw basin labels. Pending and non-converging cells get the lowest
+ * colors, each optimum its own. */
+void PlotBasins(const char *label, const BasinMap &basins) {
+  const HeatmapGrid &grid = basins.grid();
+  const int rows = static_cast<int>(grid.resolution);
+  const double max_label =
+      std::max<double>(0.0, static_cast<double>(basins.optima().size()) - 1.0);
+  ImPlot::PushColormap(ImPlotColormap_Deep);
+  ImPlot::PlotHeatmap(label, basins.labels().data(), rows, rows,
+                      static_cast<double>(BasinMap::PENDING), max_label, "",
+                      ImPlotPoint(grid.x_min, grid.y_min),
+                      ImPlotPoint(grid.x_min + grid.size,
+                                  grid.y_min + grid.size),
+                      ImPlotHeatmapFlags_None);
+  ImPlot::PopColormap();
+}
+
+/** Draw per-cell run costs from 0 to `max`. */
+template <typename T>
+void PlotCost(const char *label, const BasinMap &basins,
+              const std::vector<T> &cost, double max) {
+  const HeatmapGrid &grid = basins.grid();
+  const int rows = static_cast<int>(grid.resolution);
+  ImPlot::PushColormap(ImPlotColormap_Hot);
+  ImPlot::PlotHeatmap(label, cost.data(), rows, rows, 0.0, std::max(max, 1.0),
+                      "", ImPlotPoint(grid.x_min, grid.y_min),
+                      ImPlotPoint(grid.x_min + grid.size,
+                                  grid.y_min + grid.size),
+                      ImPlotHeatmapFlags_None);
+  ImPlot::PopColormap();
+}
+} // namespace
 
 void GuiHandle::glfw_error_callback(int error, const char *description) {
   fprintf(stderr, "GLFW Error %d: %s\n", error, description);
 }
 
-GuiHandle::GuiHandle() {
+GuiHandle::GuiHandle(std::size_t heatmap_resolution,
+                     HeatmapPrecision heatmap_precision,
+                     const std::string &heatmap_cache) {
   glfwSetErrorCallback(glfw_error_callback);
 
   if (glfwInit() == GLFW_FALSE) {
@@ -66,29 +173,9 @@ GuiHandle::GuiHandle() {
     throw std::runtime_error("Could not initialize ImGui OpenGL backend");
   }
 
-  /* Populate heatmap with 2D function values. */
-  for (std::size_t y = 0; y < RESOLUTION; y++) {
-    for (std::size_t x = 0; x < RESOLUTION; x++) {
-      const double x_coord = START[0] + static_cast<double>(x) * TICK_SIZE;
-      const double y_coord = START[1] + static_cast<double>(y) * TICK_SIZE;
-      /* No idea why but y must be inverted. For the heatmap to match the
-       * scatter plot. */
-      heatmap[y][x] = functions::f(CMyVektor<2>({x_coord, -y_coord}));
-    }
-  }
-  /* Find maximum and minimum value in heatmap. Used as boundaries for color
-   * mapping. */
-  for (std::size_t i = 0; i < RESOLUTION * RESOLUTION; i++) {
-    /* A bit weird but we know 2-dimensional arrays are in contiguous memory. We
-     * can access all elements by the second index only. */
-    const double &current = heatmap[0][i];
-    if (current > heatmap_max) {
-      heatmap_max = current;
-    }
-    if (current < heatmap_min) {
-      heatmap_min = current;
-    }
-  }
+  /* Populate heatmap with 2D function values, or map them from the cache. */
+  heatmap = CachedHeatmap(heatmap_cache, heatmap_resolution, START[0], START[1],
+                          HEATMAP_SIZE, heatmap_precision, functions::f);
 }
 
 GuiHandle::~GuiHandle() {
@@ -102,27 +189,49 @@ GuiHandle::~GuiHandle() {
 }
 
 auto GuiHandle::Update() -> bool {
+  /* Background results and ImGui state make the steady state hard to tell
+   * here, so frames are only counted. The replay enforces it. */
+  ALLOC_SCOPE("GuiHandle::Update");
+
   /* Poll and handle events (inputs, window resize, etc.) */
+  TRACE_STAGE_BEGIN("Update: events");
   glfwPollEvents();
 
   ImGui_ImplOpenGL3_NewFrame();
   ImGui_ImplGlfw_NewFrame();
   ImGui::NewFrame();
 
-  /* Finite state machine.
-   *
-   * Actually, this could be done cleaner by moving all code into the
-   * switch-case statement.
-   */
-  CalcState next_state = this->state;
+  TRACE_STAGE("Update: controls");
+
+  /* Finite state machine. Widgets work on copies of the model values and
+   * every change is applied as input event, which keeps recordings
+   * replayable. The state is sampled once so the disabled blocks below stay
+   * balanced even if an event changes it mid-frame. */
+  using CalcState = CalcModel::CalcState;
+  model.Refresh();
+  const CalcState state = model.state();
 
-  switch (this->state) {
+  switch (state) {
   case CalcState::Init:
     if (ImGui::Button("Start Calculation")) {
-      next_state = CalcState::MidCalculation;
+      if (Speculation::Run *run =
+              speculation.Lookup(model.start(), model.max_iterations());
+          run != nullptr) {
+        /* `Lookup` matches within `Speculation::TOLERANCE`, so offer the run
+         * for the model's own start, which `Apply` compares exactly. */
+        model.Precomputed(model.start(), run->max_iterations,
+                          run->trajectory);
+      }
+      Input(InputKind::StartCalculation);
     }
     break;
   case CalcState::MidCalculation:
+    if (model.failed()) {
+      if (ImGui::Button("Reset")) {
+        Input(InputKind::Reset);
+      }
+      break;
+    }
     ImGui::BeginDisabled();
     if (ImGui::Button("Start Calculation")) {
       /* nothing */
@@ -131,64 +240,158 @@ auto GuiHandle::Update() -> bool {
     break;
   case CalcState::Done:
     if (ImGui::Button("Reset")) {
-      next_state = CalcState::Init;
+      Input(InputKind::Reset);
     }
     break;
   }
 
-  if (this->state != CalcState::Init) {
+  if (state != CalcState::Init) {
     ImGui::BeginDisabled();
   }
 
-  ImGui::DragScalar("Start x", ImGuiDataType_Double, &start[0], 0.1);
-  ImGui::DragScalar("Start y", ImGuiDataType_Double, &start[1], 0.1);
+  static constexpr double START_DRAG_SPEED = 0.1;
+  CMyVektor<2> start = model.start();
+  if (ImGui::DragScalar("Start x", ImGuiDataType_Double, &start[0],
+                        START_DRAG_SPEED)) {
+    Input(InputKind::StartX, start[0]);
+  }
+  if (ImGui::DragScalar("Start y", ImGuiDataType_Double, &start[1],
+                        START_DRAG_SPEED)) {
+    Input(InputKind::StartY, start[1]);
+  }
+  /* The server rejects runs above its limit, local runs use the same. */
+  static constexpr std::size_t MAX_IT_MIN = 1;
+  static constexpr std::size_t MAX_IT_MAX = protocol::MAX_ITERATIONS;
+  std::size_t max_iterations = model.max_iterations();
+  if (ImGui::DragScalar("Max iterations", ImGuiDataType_U64, &max_iterations,
+                        1.0f, &MAX_IT_MIN, &MAX_IT_MAX)) {
+    Input(InputKind::MaxIterations, static_cast<double>(max_iterations));
+  }
 
-  if (this->state != CalcState::Init) {
+  if (state != CalcState::Init) {
     ImGui::EndDisabled();
   }
 
-  if (this->state == CalcState::Init) {
-    iteration = 0;
+  if (state == CalcState::Init) {
+    ImGui::BeginDisabled();
   }
 
-  if (this->state != CalcState::MidCalculation) {
-    ImGui::BeginDisabled();
+  /* The slider covers the whole recorded run. Seeking is cheap, so dragging
+   * updates text and plot within the same frame. */
+  static constexpr std::size_t IT_MIN = 0;
+  const std::size_t it_max = model.last_iteration();
+  std::size_t iteration = model.iteration();
+  if (ImGui::SliderScalar("Iteration step", ImGuiDataType_U64, &iteration,
+                          &IT_MIN, &it_max, nullptr,
+                          ImGuiSliderFlags_AlwaysClamp)) {
+    playback.Pause();
+    Input(InputKind::Iteration, static_cast<double>(iteration));
   }
 
-  static constexpr uint8_t IT_MIN = 0;
-  static constexpr uint8_t IT_MAX = 24;
-  ImGui::SliderScalar("Iteration step", ImGuiDataType_U8, &iteration, &IT_MIN,
-                      &IT_MAX);
+  /* Playback moves the slider like the user would, so recordings replay
+   * it as well. */
+  if (ImGui::Button(playback.playing() ? "Pause" : "Play")) {
+    if (playback.playing()) {
+      playback.Pause();
+    } else {
+      playback.Play(model.iteration() >= it_max ? 0 : model.iteration());
+    }
+  }
+  ImGui::SameLine();
+  static constexpr double RATE_MIN = 0.1;
+  static constexpr double RATE_MAX = 1.0e4;
+  double rate = playback.rate();
+  if (ImGui::DragScalar("Iterations per second", ImGuiDataType_Double, &rate,
+                        0.5f, &RATE_MIN, &RATE_MAX, "%.1f",
+                        ImGuiSliderFlags_Logarithmic)) {
+    playback.set_rate(rate);
+  }
 
-  if (this->state != CalcState::MidCalculation) {
+  if (state == CalcState::Init) {
     ImGui::EndDisabled();
   }
 
-  if (this->state == CalcState::Init) {
-    iteration_data_init =
-        IterationData<2>::AtPoint(start, functions::f, INIT_STEP_SIZE_F, 0);
+  /* Sample the path before `current()`, which sampling invalidates. */
+  TRACE_STAGE("Update: playback");
+  playback.Sync(model);
+  if (const auto played = playback.Advance(
+          ImGui::GetIO().DeltaTime, model.last_iteration(), model.complete());
+      played && *played != model.iteration()) {
+    Input(InputKind::Iteration, static_cast<double>(*played));
   }
 
-  IterationData<2> iteration_data = iteration_data_init;
-  if (this->state == CalcState::MidCalculation) {
-    for (std::size_t i = 0; i < iteration; i++) {
-      if (iteration_data.done()) {
-        next_state = CalcState::Done;
-        break;
-      }
-      iteration_data = IterationData<2>::Next(iteration_data);
+  if (const RemoteRun *remote = model.remote_run(); remote != nullptr) {
+    ImGui::Text("Server run %u: %zu iterations received%s",
+                static_cast<unsigned>(remote->run_id()), remote->size(),
+                remote->finished() ? " (finished)" : "");
+    if (const std::string error = remote->error(); !error.empty()) {
+      ImGui::Text("Server error: %s", error.c_str());
     }
   }
+  if (!input_error.empty()) {
+    ImGui::Text("Error: %s", input_error.c_str());
+  }
 
-  if (this->state == CalcState::MidCalculation ||
-      this->state == CalcState::Done) {
-    std::stringstream ss;
-    ss << iteration_data;
-    std::string str = ss.str();
+  /* Predict the run while the start point is being chosen. Drags move it in
+   * steps of the drag speed, so the neighbours one step away are likely
+   * next. */
+  TRACE_STAGE("Update: speculation");
+  const Speculation::Run *predicted = nullptr;
+  if (model.state() == CalcState::Init) {
+    speculation.Request(model.start(), START_DRAG_SPEED,
+                        model.max_iterations());
+    predicted = speculation.Lookup(model.start(), model.max_iterations());
+  }
+
+  const IterationData<2> &iteration_data = model.current();
+
+  if (model.state() != CalcState::Init) {
+    const std::string &str = model.Describe();
     ImGui::Text("%s", str.c_str());
   }
 
+  /* -- Choose what the heatmap shows -- */
+  TRACE_STAGE("Update: basins");
+  static constexpr const char *VIEW_NAMES[] = {
+      "f(x)", "Basins of attraction", "Iterations to converge",
+      "Objective evaluations"};
+  int view_index = static_cast<int>(view);
+  if (ImGui::Combo("View", &view_index, VIEW_NAMES,
+                   static_cast<int>(std::size(VIEW_NAMES)))) {
+    view = static_cast<HeatmapView>(view_index);
+  }
+
+  BasinMap *basins = nullptr;
+  if (view != HeatmapView::Function) {
+    /* Computed lazily on all cores and kept per iteration limit. Finished
+     * tiles show up as they come in. */
+    basins = &basin_maps.Get(pool, heatmap.grid(), functions::f,
+                             CalcModel::INIT_STEP_SIZE_F,
+                             model.max_iterations());
+    basins->Poll();
+    if (!basins->finished()) {
+      ImGui::ProgressBar(static_cast<float>(basins->tiles_done()) /
+                         static_cast<float>(basins->tiles_total()));
+    }
+    const int32_t start_label = basins->LabelAt(model.start());
+    if (start_label >= 0) {
+      const Point<2> &optimum = basins->optima()[start_label];
+      ImGui::Text("Start converges to optimum %d at (%.4f, %.4f), f = %.6f",
+                  start_label, optimum.vector[0], optimum.vector[1],
+                  optimum.value);
+    } else if (start_label == BasinMap::NOT_CONVERGED) {
+      ImGui::Text("Start does not converge within %zu iterations",
+                  model.max_iterations());
+    }
+    if (view != HeatmapView::Basins && basins->cells_done() > 0) {
+      ImGui::Text("Up to %u iterations, %zu of %zu start points hit the limit",
+                  basins->max_iterations_used(), basins->limit_hits(),
+                  basins->cells_done());
+    }
+  }
+
   /* -- Make 2D visualization of functions::f -- */
+  TRACE_STAGE("Update: plot");
 
   /* Populate plot points as C array types. */
   const double opt_x[1] = {iteration_data.current.vector[0]};
@@ -199,18 +402,77 @@ auto GuiHandle::Update() -> bool {
   const double test_y[1] = {iteration_data.test.vector[1]};
 
   ImPlot::PushColormap(ImPlotColormap_Viridis);
+  bool hovered = false;
+  CMyVektor<2> mouse{};
   if (ImPlot::BeginPlot("Heatmap")) {
-    ImPlot::PlotHeatmap(
-        "f(x)", heatmap[0], RESOLUTION, RESOLUTION, heatmap_min, heatmap_max,
-        "", ImPlotPoint(START[0], START[1]),
-        ImPlotPoint(START[0] + HEATMAP_SIZE, START[1] + HEATMAP_SIZE),
-        ImPlotHeatmapFlags_None);
+    switch (view) {
+    case HeatmapView::Function:
+      PlotHeatmap("f(x)", heatmap);
+      break;
+    case HeatmapView::Basins:
+      PlotBasins("Basins", *basins);
+      break;
+    case HeatmapView::Iterations:
+      PlotCost("Iterations", *basins, basins->iterations(),
+               static_cast<double>(basins->max_iterations_used()));
+      break;
+    case HeatmapView::Evaluations:
+      PlotCost("Evaluations", *basins, basins->evaluations(),
+               (static_cast<double>(basins->max_iterations_used()) + 1.0) *
+                   IterationData<2>::EVALUATIONS_PER_ITERATION);
+      break;
+    }
+    if (predicted != nullptr) {
+      ImPlot::PlotLine("Predicted path", predicted->path_x.data(),
+                       predicted->path_y.data(),
+                       static_cast<int>(predicted->path_x.size()));
+    }
+    if (!playback.path_x().empty()) {
+      ImPlot::PlotLine("Path", playback.path_x().data(),
+                       playback.path_y().data(),
+                       static_cast<int>(playback.path_x().size()));
+    }
+    if (playback.playing()) {
+      const CMyVektor<2> animated = playback.Interpolated();
+      const double animated_x[1] = {animated[0]};
+      const double animated_y[1] = {animated[1]};
+      ImPlot::PlotScatter("Playback", animated_x, animated_y, 1);
+    }
     ImPlot::PlotScatter("Optimum", opt_x, opt_y, 1);
     ImPlot::PlotScatter("Next point", next_x, next_y, 1);
     ImPlot::PlotScatter("Test point", test_x, test_y, 1);
+    if (ImPlot::IsPlotHovered()) {
+      const ImPlotPoint pos = ImPlot::GetPlotMousePos();
+      mouse = CMyVektor<2>{pos.x, pos.y};
+      hovered = true;
+    }
     ImPlot::EndPlot();
   }
+  ImPlot::PopColormap();
+
+  /* Hover probe: Show the interpolated estimate right away and replace it
+   * with the exact values once the probe thread has computed them. */
+  TRACE_STAGE("Update: probe");
+  if (hovered) {
+    probe.Request(mouse);
+    const auto exact = probe.Lookup(mouse);
+    const Heatmap::Sample estimate = heatmap.Interpolate(mouse);
+    const double value = exact ? exact->value : estimate.value;
+    const CMyVektor<2> grad = exact ? exact->gradient : estimate.gradient;
+    const double distance =
+        (mouse + -1.0 * iteration_data.current.vector).norm();
+    ImGui::Text("f(%.4f, %.4f) = %.6f, grad f = (%.4f, %.4f), distance to x = "
+                "%.4f (%s)",
+                mouse[0], mouse[1], value, grad[0], grad[1], distance,
+                exact ? "exact" : "estimate");
+  }
+
+#if defined(PLOTTINGS_EVAL_PROFILE) && PLOTTINGS_EVAL_PROFILE > 0
+  TRACE_STAGE("Update: evaluations");
+  ShowEvalProfile();
+#endif
 
+  TRACE_STAGE("Update: render");
   ImGui::Render();
   int display_w, display_h;
   glfwGetFramebufferSize(this->glfw_window, &display_w, &display_h);
@@ -224,7 +486,35 @@ auto GuiHandle::Update() -> bool {
   glClear(GL_COLOR_BUFFER_BIT);
   ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
+  TRACE_STAGE("Update: swap");
   glfwSwapBuffers(this->glfw_window);
-  this->state = next_state;
   return glfwWindowShouldClose(this->glfw_window);
 }
+
+void GuiHandle::StartRecording() {
+  recording = InputLog{};
+  recording_start = ImGui::GetTime();
+  recording_enabled = true;
+}
+
+void GuiHandle::Attach(uint32_t run_id) {
+  try {
+    model.Attach(run_id);
+    input_error.clear();
+  } catch (const std::exception &e) {
+    input_error = e.what();
+  }
+}
+
+void GuiHandle::Input(InputKind kind, double value) {
+  const InputEvent event{ImGui::GetTime() - recording_start, kind, value};
+  try {
+    model.Apply(event);
+    input_error.clear();
+  } catch (const std::exception &e) {
+    input_error = e.what();
+  }
+  if (recording_enabled) {
+    recording.events.push_back(event);
+  }
+}
@@ -12,20 +12,48 @@
  * @date 03-05-2024
  */
 
+#include "basin_map.hpp"
+#include "calc_model.hpp"
 #include "functions.hpp"
-#include "iteration.hpp"
+#include "heatmap.hpp"
+#include "heatmap_file.hpp"
+#include "input_log.hpp"
+#include "playback.hpp"
+#include "probe.hpp"
+#include "speculation.hpp"
+#include "thread_pool.hpp"
 #include <GLFW/glfw3.h>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <implot.h>
+#include <memory>
 
 /** User interface handle */
 class GuiHandle {
 public:
-  /** Handle constructor. Will initialize the UI and throw exceptions on
-   * failure. */
-  GuiHandle();
+  /** Default heatmap subdivisions per dimension. */
+  static constexpr std::size_t RESOLUTION = 64;
+
+  /** Heatmap size in x- and y-direction. */
+  static constexpr double HEATMAP_SIZE = 4.0;
+
+  /** Start corner of heatmap. */
+  static constexpr double START[2] = {-HEATMAP_SIZE / 2.0, -HEATMAP_SIZE / 2.0};
+
+  /**
+   * Handle constructor. Will initialize the UI and throw exceptions on
+   * failure.
+   *
+   * @param heatmap_resolution Heatmap subdivisions per dimension.
+   * @param heatmap_precision Element type of the heatmap.
+   * @param heatmap_cache Directory of cached heatmap files. Empty to always
+   * compute the heatmap.
+   */
+  explicit GuiHandle(
+      std::size_t heatmap_resolution = RESOLUTION,
+      HeatmapPrecision heatmap_precision = HeatmapPrecision::Float32,
+      const std::string &heatmap_cache = default_heatmap_cache());
 
   /** Handle deconstructor used to clean up on program exit. */
   ~GuiHandle();
@@ -37,61 +65,81 @@ public:
    */
   auto Update() -> bool;
 
-private:
   /**
-   * State of steepest-descent calculation.
+   * Record all user input from now on. Timestamps are relative to this call.
    */
-  enum class CalcState {
-    /** Init-state: Customization of initialization value possible. */
-    Init,
-    /** Calculating: Customization of initialization value not possible. */
-    MidCalculation,
-    /** Calculation is done. Show result until the user clicks on 'reset'. */
-    Done,
-  };
+  void StartRecording();
 
+  /** Input recorded since `StartRecording()`. */
+  [[nodiscard]] const InputLog &Recording() const { return recording; }
+
+  /** Run calculations on the compute server at `endpoint`. The UI becomes a
+   * viewer of the runs it starts there. */
+  void Connect(const std::string &endpoint) { model.Connect(endpoint); }
+
+  /** Show run `run_id` of the compute server, e.g. one already in progress.
+   * Requires `Connect()`. Errors, e.g. an unreachable server, are shown in
+   * the UI. */
+  void Attach(uint32_t run_id);
+
+private:
   /** GLFW window handle. Initialized during object construction. */
   GLFWwindow *glfw_window{};
 
-  /** Current state of finite state machine. */
-  CalcState state{CalcState::Init};
-
   /** GLFW error callback. Not thread-safe. */
   static void glfw_error_callback(int error, const char *description);
 
-  /** Start vector to start optimization from. */
-  CMyVektor<2> start{0.2, -2.1};
+  /** Calculation state. Changed only by applying input events. */
+  CalcModel model{};
 
-  /** Iteration index to visualize. */
-  uint8_t iteration{0};
+  /** Apply an input event to the model and record it if recording is
+   * enabled. */
+  void Input(InputKind kind, double value = 0.0);
 
-  static constexpr double INIT_STEP_SIZE_F = 1.0;
+  /** Whether user input is recorded. */
+  bool recording_enabled{false};
 
-  /** First gradient descent iteration with index zero. */
-  IterationData<2> iteration_data_init{
-      IterationData<2>::AtPoint(start, functions::f, INIT_STEP_SIZE_F, 0)};
+  /** `ImGui::GetTime()` when the recording started. */
+  double recording_start{};
 
-  /** Heatmap subdivisions per dimension. */
-  static constexpr std::size_t RESOLUTION = 64;
+  /** Recorded user input. */
+  InputLog recording{};
 
-  /** Heatmap size in x- and y-direction. */
-  static constexpr double HEATMAP_SIZE = 4.0;
+  /** Error of the last input event, e.g. unreachable compute server. */
+  std::string input_error{};
 
-  /** Axis tick step size. */
-  static constexpr double TICK_SIZE =
-      HEATMAP_SIZE / static_cast<double>(RESOLUTION);
+  /** What the heatmap shows. */
+  enum class HeatmapView {
+    /** Values of f(x). */
+    Function,
+    /** Optimum reached from each cell. */
+    Basins,
+    /** Iterations each cell's run needs until `done()`. */
+    Iterations,
+    /** Objective evaluations each cell's run needs. */
+    Evaluations,
+  };
+  HeatmapView view{HeatmapView::Function};
 
-  /** Start corner of heatmap. */
-  static constexpr double START[2] = {-HEATMAP_SIZE / 2.0, -HEATMAP_SIZE / 2.0};
+  /** Animated playback of the run. */
+  Playback playback{};
+
+  /** Runs recorded in the background while the start point is dragged. */
+  Speculation speculation{functions::f, CalcModel::INIT_STEP_SIZE_F};
+
+  /** Workers for background computations. */
+  ThreadPool pool{};
 
-  /** Heatmap as C-style array in two dimensions. */
-  double heatmap[RESOLUTION][RESOLUTION];
+  /** Basin-of-attraction and convergence-cost maps by iteration limit.
+   * Computed when first shown. */
+  BasinMapCache basin_maps{};
 
-  /** Maximum value found in heatmap. */
-  double heatmap_max{-INFINITY};
+  /** Exact evaluation of f(x) under the mouse cursor. */
+  Probe probe{functions::f};
 
-  /** Minimum value found in heatmap. */
-  double heatmap_min{INFINITY};
+  /** Values of f(x) on the heatmap grid. Heap-allocated, so the resolution
+   * does not change the size of the handle. */
+  Heatmap heatmap{};
 };
 
 #endif // UI_H_
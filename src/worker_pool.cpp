@@ -0,0 +1,290 @@
+/**
+ * @file worker_pool.cpp
+ *
+ * @brief POSIX implementation of `WorkerPool`.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "worker_pool.hpp"
+#include "worker_protocol.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+/** Time a worker gets to exit after its input was closed. */
+constexpr std::chrono::milliseconds EXIT_GRACE{500};
+constexpr std::chrono::milliseconds EXIT_POLL{5};
+
+[[noreturn]] void throw_errno(const std::string &what) {
+  throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+std::string join(const std::vector<std::string> &command) {
+  std::string text;
+  for (const auto &arg : command) {
+    text += (text.empty() ? "" : " ") + arg;
+  }
+  return text;
+}
+
+void set_timeout(int fd, int option, std::chrono::milliseconds timeout) {
+  timeval tv{};
+  tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+  tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+  if (::setsockopt(fd, SOL_SOCKET, option, &tv, sizeof(tv)) != 0) {
+    throw_errno("Could not set worker timeout");
+  }
+}
+} // namespace
+
+WorkerPool::WorkerPool(Options options) : options(std::move(options)) {
+  if (this->options.command.empty()) {
+    throw std::runtime_error("Worker command is empty");
+  }
+  std::size_t count = this->options.workers;
+  if (count == 0) {
+    count = std::max(1U, std::thread::hardware_concurrency());
+  }
+  workers.reserve(count);
+  try {
+    for (std::size_t i = 0; i < count; i++) {
+      start(*workers.emplace_back(std::make_unique<Worker>()));
+    }
+  } catch (...) {
+    for (auto &worker : workers) {
+      stop(*worker, EXIT_GRACE);
+    }
+    throw;
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  for (auto &worker : workers) {
+    stop(*worker, EXIT_GRACE);
+  }
+}
+
+void WorkerPool::start(Worker &worker) const {
+  int channel[2];
+  if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, channel) != 0) {
+    throw_errno("Could not create worker channel");
+  }
+  /* Reports a failed exec, closed by a successful one. */
+  int status[2];
+  if (::pipe2(status, O_CLOEXEC) != 0) {
+    ::close(channel[0]);
+    ::close(channel[1]);
+    throw_errno("Could not create worker status pipe");
+  }
+
+  /* Only async-signal-safe calls between fork and exec. */
+  std::vector<char *> argv;
+  for (const auto &arg : options.command) {
+    argv.push_back(const_cast<char *>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  const pid_t pid = ::fork();
+  if (pid == 0) {
+    ::dup2(channel[1], STDIN_FILENO);
+    ::dup2(channel[1], STDOUT_FILENO);
+    ::execvp(argv[0], argv.data());
+    const int error = errno;
+    static_cast<void>(::write(status[1], &error, sizeof(error)));
+    ::_exit(127);
+  }
+  const int fork_error = errno;
+  ::close(channel[1]);
+  ::close(status[1]);
+  if (pid < 0) {
+    ::close(channel[0]);
+    ::close(status[0]);
+    errno = fork_error;
+    throw_errno("Could not start worker");
+  }
+
+  int exec_error = 0;
+  ssize_t got = 0;
+  do {
+    got = ::read(status[0], &exec_error, sizeof(exec_error));
+  } while (got < 0 && errno == EINTR);
+  ::close(status[0]);
+  worker.pid = pid;
+  worker.channel = Socket(channel[0]);
+  if (got > 0) {
+    stop(worker, EXIT_GRACE);
+    errno = exec_error;
+    throw_errno("Could not start worker '" + join(options.command) + "'");
+  }
+  if (options.timeout.count() > 0) {
+    set_timeout(channel[0], SO_RCVTIMEO, options.timeout);
+    set_timeout(channel[0], SO_SNDTIMEO, options.timeout);
+  }
+}
+
+void WorkerPool::stop(Worker &worker, std::chrono::milliseconds grace) {
+  if (worker.pid < 0) {
+    return;
+  }
+  /* A closed input asks the worker to exit. */
+  worker.channel = Socket();
+  const auto deadline = std::chrono::steady_clock::now() + grace;
+  while (::waitpid(worker.pid, nullptr, WNOHANG) == 0) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      ::kill(worker.pid, SIGKILL);
+      ::waitpid(worker.pid, nullptr, 0);
+      break;
+    }
+    std::this_thread::sleep_for(EXIT_POLL);
+  }
+  worker.pid = -1;
+}
+
+std::vector<WorkerPool::Worker *> WorkerPool::acquire(std::size_t count) {
+  std::unique_lock lock(mutex);
+  const auto idle = [](const auto &worker) { return worker->idle; };
+  released.wait(lock, [&] {
+    return std::any_of(workers.begin(), workers.end(), idle);
+  });
+  std::vector<Worker *> taken;
+  for (auto &worker : workers) {
+    if (taken.size() == count) {
+      break;
+    }
+    if (worker->idle) {
+      worker->idle = false;
+      taken.push_back(worker.get());
+    }
+  }
+  return taken;
+}
+
+void WorkerPool::release(const std::vector<Worker *> &taken) {
+  {
+    const std::lock_guard lock(mutex);
+    for (Worker *worker : taken) {
+      worker->idle = true;
+    }
+  }
+  released.notify_all();
+}
+
+void WorkerPool::send(const Chunk &chunk, const double *points,
+                      std::size_t dimension) {
+  Worker &worker = *chunk.worker;
+  if (worker.pid < 0) {
+    restarted++;
+    start(worker);
+  }
+  requested++;
+  const worker_protocol::Request request{static_cast<uint32_t>(dimension),
+                                         static_cast<uint32_t>(chunk.count)};
+  worker.channel.WriteAll(&request, sizeof(request));
+  worker.channel.WriteAll(points + chunk.first * dimension,
+                          chunk.count * dimension * sizeof(double));
+}
+
+void WorkerPool::receive(const Chunk &chunk, double *values) {
+  worker_protocol::Response response{};
+  if (!chunk.worker->channel.ReadExact(&response, sizeof(response))) {
+    throw std::runtime_error("Worker exited");
+  }
+  if (response.count != chunk.count) {
+    throw std::runtime_error("Worker sent " + std::to_string(response.count) +
+                             " values, expected " +
+                             std::to_string(chunk.count));
+  }
+  if (!chunk.worker->channel.ReadExact(values + chunk.first,
+                                       chunk.count * sizeof(double))) {
+    throw std::runtime_error("Worker exited");
+  }
+}
+
+void WorkerPool::evaluate_round(const std::vector<Worker *> &taken,
+                                const double *points, std::size_t count,
+                                std::size_t dimension, double *values) {
+  std::vector<Chunk> chunks;
+  const std::size_t per_worker = (count + taken.size() - 1) / taken.size();
+  for (std::size_t first = 0, i = 0; first < count; i++) {
+    const std::size_t size = std::min(per_worker, count - first);
+    chunks.push_back(Chunk{taken[i], first, size});
+    first += size;
+  }
+
+  /* A failed worker is killed right away, so it cannot answer a later
+   * request with a stale result. The next request restarts it. */
+  const auto attempt = [](Chunk &chunk, const auto &step) {
+    try {
+      step();
+    } catch (const std::exception &e) {
+      chunk.failed = true;
+      chunk.error = e.what();
+      stop(*chunk.worker, std::chrono::milliseconds{0});
+    }
+  };
+
+  /* Pipelined: every worker gets its points before the first answer is
+   * read. */
+  for (Chunk &chunk : chunks) {
+    attempt(chunk, [&] { send(chunk, points, dimension); });
+  }
+  for (Chunk &chunk : chunks) {
+    if (!chunk.failed) {
+      attempt(chunk, [&] { receive(chunk, values); });
+    }
+  }
+
+  for (Chunk &chunk : chunks) {
+    for (std::size_t retry = 0; chunk.failed && retry < options.max_retries;
+         retry++) {
+      chunk.failed = false;
+      attempt(chunk, [&] { send(chunk, points, dimension); });
+      if (!chunk.failed) {
+        attempt(chunk, [&] { receive(chunk, values); });
+      }
+    }
+    if (chunk.failed) {
+      throw std::runtime_error("Worker '" + join(options.command) +
+                               "' failed " +
+                               std::to_string(options.max_retries + 1) +
+                               " times: " + chunk.error);
+    }
+  }
+}
+
+void WorkerPool::Evaluate(const double *points, std::size_t count,
+                          std::size_t dimension, double *values) {
+  if (count == 0) {
+    return;
+  }
+  if (dimension == 0 || dimension > worker_protocol::MAX_DIMENSION) {
+    throw std::runtime_error("Unsupported dimension " +
+                             std::to_string(dimension));
+  }
+  const std::vector<Worker *> taken = acquire(count);
+  try {
+    /* One slice per worker and round, each within the protocol limit. */
+    const std::size_t round = worker_protocol::MAX_POINTS * taken.size();
+    for (std::size_t first = 0; first < count; first += round) {
+      evaluate_round(taken, points + first * dimension,
+                     std::min(round, count - first), dimension,
+                     values + first);
+    }
+  } catch (...) {
+    release(taken);
+    throw;
+  }
+  release(taken);
+  evaluated += count;
+}
@@ -0,0 +1,191 @@
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+/**
+ * @file worker_pool.hpp
+ *
+ * @brief Objectives evaluated by external worker processes.
+ *
+ * For objectives that only exist as separate programs, e.g. simulators. A
+ * `WorkerPool` starts a fixed number of worker processes speaking
+ * worker_protocol.hpp and splits every batch of points among the idle
+ * ones: all requests are written before the first answer is read, so the
+ * workers compute in parallel.
+ *
+ * A worker that exits, sends garbage or exceeds the timeout is killed,
+ * restarted and sent its points again, up to `max_retries` times. Only
+ * then does the evaluation throw `std::runtime_error`. Other workers and
+ * the calling process are not affected.
+ *
+ * `ExternalObjective` turns a pool into a `FunctionPtr` for the optimizers.
+ * It evaluates whole gradient stencils per request through a
+ * `StencilCache`, so a gradient descent iteration costs two round trips.
+ *
+ * Workers talk to the pool through a Unix-domain socket pair on their
+ * standard input and output, so writes to a crashed worker fail instead of
+ * raising SIGPIPE. To the worker it behaves like a pair of pipes.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "cmyvektor.hpp"
+#include "socket.hpp"
+#include "stencil_cache.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/** Fixed set of objective worker processes. */
+class WorkerPool {
+public:
+  struct Options {
+    /** Program and its arguments, looked up in `PATH`. */
+    std::vector<std::string> command{};
+    /** Worker processes. Zero means one per hardware thread. */
+    std::size_t workers{0};
+    /** Restarts per request before giving up. */
+    std::size_t max_retries{2};
+    /** Longest wait for an answer. Zero waits forever. */
+    std::chrono::milliseconds timeout{0};
+  };
+
+  /** Start all workers. Throws `std::runtime_error` if the command cannot
+   * be started. */
+  explicit WorkerPool(Options options);
+
+  /** Closes the workers' input and waits for them to exit. */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  /**
+   * Store the objective at `count` points in `values[0 .. count)`. Point i
+   * is `points[i * dimension .. (i + 1) * dimension)`. Thread-safe,
+   * concurrent calls share the idle workers.
+   */
+  void Evaluate(const double *points, std::size_t count,
+                std::size_t dimension, double *values);
+
+  /** Number of worker processes. */
+  [[nodiscard]] std::size_t size() const { return workers.size(); }
+
+  /** Points evaluated so far. */
+  [[nodiscard]] uint64_t evaluations() const { return evaluated.load(); }
+
+  /** Requests sent so far, retries included. */
+  [[nodiscard]] uint64_t requests() const { return requested.load(); }
+
+  /** Workers restarted after a failure so far. */
+  [[nodiscard]] uint64_t restarts() const { return restarted.load(); }
+
+private:
+  struct Worker {
+    /** -1 while stopped. */
+    pid_t pid{-1};
+    Socket channel{};
+    bool idle{true};
+  };
+
+  /** A slice of the points of one `Evaluate` call. */
+  struct Chunk {
+    Worker *worker;
+    std::size_t first;
+    std::size_t count;
+    bool failed{false};
+    std::string error{};
+  };
+
+  Options options;
+  std::vector<std::unique_ptr<Worker>> workers{};
+
+  /** Protects `idle` of all workers. */
+  std::mutex mutex{};
+  std::condition_variable released{};
+
+  std::atomic<uint64_t> evaluated{0};
+  std::atomic<uint64_t> requested{0};
+  std::atomic<uint64_t> restarted{0};
+
+  /** Wait for an idle worker and take up to `count` of them. */
+  std::vector<Worker *> acquire(std::size_t count);
+  void release(const std::vector<Worker *> &taken);
+
+  void start(Worker &worker) const;
+  /** Close the input of `worker` and kill it if it has not exited after
+   * `grace`. */
+  static void stop(Worker &worker, std::chrono::milliseconds grace);
+
+  /** Send the points of `chunk`, restarting its worker if it was stopped. */
+  void send(const Chunk &chunk, const double *points, std::size_t dimension);
+  static void receive(const Chunk &chunk, double *values);
+
+  /** Evaluate at most `MAX_POINTS` points per worker in `taken`. */
+  void evaluate_round(const std::vector<Worker *> &taken, const double *points,
+                      std::size_t count, std::size_t dimension,
+                      double *values);
+};
+
+/**
+ * Objective of dimension N evaluated by a `WorkerPool`.
+ *
+ * While an instance exists, `function()` evaluates through its pool on any
+ * thread, e.g. in the workers of `RunBatch`. Instances of the same N nest:
+ * the newest one wins until it is destroyed.
+ */
+template <std::size_t N> class ExternalObjective {
+public:
+  explicit ExternalObjective(WorkerPool &pool);
+  ~ExternalObjective();
+
+  ExternalObjective(const ExternalObjective &) = delete;
+  ExternalObjective &operator=(const ExternalObjective &) = delete;
+
+  /** The objective for the optimizers. */
+  [[nodiscard]] static FunctionPtr<N> function() { return evaluate; }
+
+private:
+  static inline std::atomic<WorkerPool *> active{nullptr};
+  /** Changes with `active`, so no thread uses stencils of another pool. */
+  static inline std::atomic<uint64_t> generation{0};
+
+  WorkerPool *previous;
+
+  static double evaluate(const CMyVektor<N> &x);
+};
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+
+template <std::size_t N>
+ExternalObjective<N>::ExternalObjective(WorkerPool &pool)
+    : previous(active.exchange(&pool)) {
+  generation++;
+}
+
+template <std::size_t N> ExternalObjective<N>::~ExternalObjective() {
+  active = previous;
+  generation++;
+}
+
+template <std::size_t N>
+double ExternalObjective<N>::evaluate(const CMyVektor<N> &x) {
+  thread_local StencilCache<N> cache{};
+  thread_local uint64_t cached_generation = 0;
+  if (const uint64_t current = generation.load();
+      current != cached_generation) {
+    cache.Clear();
+    cached_generation = current;
+  }
+  WorkerPool *pool = active.load();
+  return cache.Get(x, [pool](const double *points, double *values) {
+    pool->Evaluate(points, StencilCache<N>::POINTS, N, values);
+  });
+}
+
+#endif // WORKER_POOL_H_
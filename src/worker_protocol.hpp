@@ -0,0 +1,133 @@
+#ifndef WORKER_PROTOCOL_H_
+#define WORKER_PROTOCOL_H_
+/**
+ * @file worker_protocol.hpp
+ *
+ * @brief Wire format between `WorkerPool` and objective worker processes.
+ *
+ * A worker reads requests from standard input and answers each on standard
+ * output, in order, until standard input is closed. A request is a
+ * `Request` followed by `count` points of `dimension` doubles, the answer a
+ * `Response` followed by the `count` values. All numbers are in host byte
+ * order, the worker always runs on the same machine.
+ *
+ * Requests may be sent before the previous answer arrived. A worker that
+ * cannot evaluate a point exits with a non-zero status. Diagnostics go to
+ * standard error.
+ *
+ * `Serve` implements the worker side for objectives written in C++, see
+ * objective_worker.cpp.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace worker_protocol {
+struct Request {
+  uint32_t dimension{};
+  uint32_t count{};
+};
+static_assert(sizeof(Request) == 8);
+
+struct Response {
+  uint32_t count{};
+  uint32_t reserved{};
+};
+static_assert(sizeof(Response) == 8);
+
+/** Most points in one request. Protects against garbage on the wire. */
+static constexpr uint32_t MAX_POINTS = 1024 * 1024;
+
+/** Largest supported dimension. */
+static constexpr uint32_t MAX_DIMENSION = 1024;
+
+/**
+ * Read exactly `size` bytes from `fd`.
+ *
+ * @returns 'false' if `fd` was closed before the first byte.
+ */
+inline bool ReadExact(int fd, void *data, std::size_t size) {
+  auto *bytes = static_cast<char *>(data);
+  std::size_t done = 0;
+  while (done < size) {
+    const ssize_t got = ::read(fd, bytes + done, size - done);
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("Could not read request: ") +
+                               std::strerror(errno));
+    }
+    if (got == 0) {
+      if (done == 0) {
+        return false;
+      }
+      throw std::runtime_error("Input closed in the middle of a request");
+    }
+    done += static_cast<std::size_t>(got);
+  }
+  return true;
+}
+
+/** Write all `size` bytes to `fd`. */
+inline void WriteAll(int fd, const void *data, std::size_t size) {
+  const auto *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    const ssize_t written = ::write(fd, bytes, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::string("Could not write response: ") +
+                               std::strerror(errno));
+    }
+    bytes += written;
+    size -= static_cast<std::size_t>(written);
+  }
+}
+
+/**
+ * Answer requests on standard input until it is closed.
+ *
+ * @param dimension Accepted point dimension.
+ * @param evaluate Callable `double(const double *x)` with `dimension`
+ * coordinates at `x`.
+ */
+template <typename Evaluate>
+void Serve(std::size_t dimension, Evaluate &&evaluate) {
+  std::vector<double> points;
+  std::vector<double> values;
+  Request request{};
+  while (ReadExact(STDIN_FILENO, &request, sizeof(request))) {
+    if (request.dimension != dimension || request.count > MAX_POINTS) {
+      throw std::runtime_error(
+          "Request for " + std::to_string(request.count) + " points of " +
+          std::to_string(request.dimension) + " coordinates, expected " +
+          std::to_string(dimension));
+    }
+    points.resize(std::size_t{request.count} * dimension);
+    if (!points.empty() &&
+        !ReadExact(STDIN_FILENO, points.data(),
+                   points.size() * sizeof(double))) {
+      throw std::runtime_error("Input closed in the middle of a request");
+    }
+    values.resize(request.count);
+    for (std::size_t i = 0; i < request.count; i++) {
+      values[i] = evaluate(points.data() + i * dimension);
+    }
+    const Response response{request.count, 0};
+    WriteAll(STDOUT_FILENO, &response, sizeof(response));
+    WriteAll(STDOUT_FILENO, values.data(), values.size() * sizeof(double));
+  }
+}
+} // namespace worker_protocol
+
+#endif // WORKER_PROTOCOL_H_
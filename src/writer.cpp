@@ -0,0 +1,103 @@
+/**
+ * @file writer.cpp
+ *
+ * @brief Implementation of the output buffer.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "writer.hpp"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+OutputFormat parse_output_format(std::string_view name) {
+  if (name == "text") {
+    return OutputFormat::Text;
+  }
+  if (name == "csv") {
+    return OutputFormat::Csv;
+  }
+  if (name == "jsonl") {
+    return OutputFormat::JsonLines;
+  }
+  if (name == "binary") {
+    return OutputFormat::Binary;
+  }
+  throw std::runtime_error("Unknown output format '" + std::string(name) +
+                           "', expected text, csv, jsonl or binary");
+}
+
+OutputBuffer::OutputBuffer(std::FILE *file) : file(file) {}
+
+OutputBuffer::~OutputBuffer() {
+  if (used > 0) {
+    std::fwrite(buffer.get(), 1, used, file);
+  }
+  std::fflush(file);
+}
+
+void OutputBuffer::drain() {
+  if (used > 0 && std::fwrite(buffer.get(), 1, used, file) != used) {
+    throw std::runtime_error("Could not write output");
+  }
+  used = 0;
+}
+
+char *OutputBuffer::reserve(std::size_t size) {
+  if (BUFFER_SIZE - used < size) {
+    drain();
+  }
+  return buffer.get() + used;
+}
+
+void OutputBuffer::Text(std::string_view text) {
+  if (text.size() > BUFFER_SIZE) {
+    drain();
+    Raw(text.data(), text.size());
+    return;
+  }
+  std::memcpy(reserve(text.size()), text.data(), text.size());
+  used += text.size();
+}
+
+void OutputBuffer::Char(char c) {
+  *reserve(1) = c;
+  used++;
+}
+
+void OutputBuffer::Number(double value) {
+  /* The longest shortest representation, e.g. -2.2250738585072014e-308. */
+  static constexpr std::size_t MAX_LENGTH = 32;
+  char *first = reserve(MAX_LENGTH);
+  const auto [last, error] = std::to_chars(first, first + MAX_LENGTH, value);
+  used += static_cast<std::size_t>(last - first);
+}
+
+void OutputBuffer::Integer(uint64_t value) {
+  static constexpr std::size_t MAX_LENGTH = 20;
+  char *first = reserve(MAX_LENGTH);
+  const auto [last, error] = std::to_chars(first, first + MAX_LENGTH, value);
+  used += static_cast<std::size_t>(last - first);
+}
+
+void OutputBuffer::Raw(const void *data, std::size_t size) {
+  if (size > BUFFER_SIZE) {
+    drain();
+    if (std::fwrite(data, 1, size, file) != size) {
+      throw std::runtime_error("Could not write output");
+    }
+    return;
+  }
+  std::memcpy(reserve(size), data, size);
+  used += size;
+}
+
+void OutputBuffer::Flush() {
+  drain();
+  if (std::fflush(file) != 0 || std::ferror(file) != 0) {
+    throw std::runtime_error("Could not write output");
+  }
+}
@@ -0,0 +1,363 @@
+#ifndef WRITER_H_
+#define WRITER_H_
+/**
+ * @file writer.hpp
+ *
+ * @brief Machine-readable output of iterations and run results.
+ *
+ * Besides the human-readable text of `operator<<`, iterations and results
+ * can be written as
+ *
+ *  - CSV with a header line,
+ *  - JSON Lines, one object per line,
+ *  - binary records: an 8-byte magic `RECORD_MAGIC`, the `RecordKind` and
+ *    the dimension as little-endian `uint32_t`, then fixed-size records.
+ *    An iteration record is its `uint64_t` index followed by the compute
+ *    server's record encoding (see protocol.hpp). A result record is start,
+ *    end point and value, gradient norm as `double`, then iterations and
+ *    the convergence flag as `uint64_t`.
+ *
+ * Numbers are formatted with `std::to_chars`, which gives the shortest text
+ * that reads back to the same double. Everything goes through an
+ * `OutputBuffer` that hands large blocks to the file.
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "batch.hpp"
+#include "iteration.hpp"
+#include "protocol.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+/** Output format of iterations and results. */
+enum class OutputFormat {
+  /** Human-readable, not meant to be parsed. */
+  Text,
+  Csv,
+  JsonLines,
+  Binary,
+};
+
+/** Parse "text", "csv", "jsonl" or "binary". Throws `std::runtime_error`
+ * for anything else. */
+[[nodiscard]] OutputFormat parse_output_format(std::string_view name);
+
+/** Kind of the records in a binary stream. */
+enum class RecordKind : uint32_t {
+  Iteration = 1,
+  Result = 2,
+};
+
+/** First bytes of a binary stream. */
+static constexpr char RECORD_MAGIC[8] = {'P', 'L', 'T', 'R',
+                                          'E', 'C', '1', '\0'};
+
+/** Write buffer in front of a `FILE`. */
+class OutputBuffer {
+public:
+  /** Bytes collected before they are handed to the file. */
+  static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+  /** Write to `file`, which stays owned by the caller. */
+  explicit OutputBuffer(std::FILE *file);
+
+  /** Flushes. Errors are lost, call `Flush()` to see them. */
+  ~OutputBuffer();
+
+  OutputBuffer(const OutputBuffer &) = delete;
+  OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+  void Text(std::string_view text);
+  void Char(char c);
+
+  /** Shortest text that reads back as `value`. */
+  void Number(double value);
+  void Integer(uint64_t value);
+
+  /** Bytes as they are in memory. */
+  void Raw(const void *data, std::size_t size);
+
+  /** Write everything to the file and flush it. Throws
+   * `std::runtime_error` on failure. */
+  void Flush();
+
+private:
+  std::FILE *file;
+  std::unique_ptr<char[]> buffer{new char[BUFFER_SIZE]};
+  std::size_t used{0};
+
+  /** Pointer to `size` free bytes. `size` must not exceed the buffer. */
+  char *reserve(std::size_t size);
+  /** Hand the buffered bytes to the file. */
+  void drain();
+};
+
+/** Writes `IterationData` records. Can be passed as log to
+ * `gradient_descent`. */
+template <std::size_t N> class IterationWriter {
+public:
+  /** Writes the CSV header or the binary stream header. */
+  IterationWriter(OutputBuffer &out, OutputFormat format);
+
+  void Write(const IterationData<N> &iteration);
+
+  void operator()(const IterationData<N> &iteration) { Write(iteration); }
+
+private:
+  OutputBuffer &out;
+  OutputFormat format;
+  /** Reused binary record. */
+  std::vector<uint8_t> record{};
+};
+
+/** Writes `RunResult` records. */
+template <std::size_t N> class ResultWriter {
+public:
+  /** Writes the CSV header or the binary stream header. */
+  ResultWriter(OutputBuffer &out, OutputFormat format);
+
+  void Write(const RunResult<N> &result);
+
+  void operator()(const RunResult<N> &result) { Write(result); }
+
+private:
+  OutputBuffer &out;
+  OutputFormat format;
+};
+
+/* ------------ IMPLEMENTATION ----------------------------------------- */
+namespace writer_detail {
+/** Write the binary stream header. */
+inline void binary_header(OutputBuffer &out, RecordKind kind,
+                          std::size_t dimension) {
+  const uint32_t header[2] = {static_cast<uint32_t>(kind),
+                              static_cast<uint32_t>(dimension)};
+  out.Raw(RECORD_MAGIC, sizeof(RECORD_MAGIC));
+  out.Raw(header, sizeof(header));
+}
+
+/** CSV column names `prefix_0`, ..., `prefix_{N-1}`, each followed by a
+ * comma. */
+template <std::size_t N>
+void csv_columns(OutputBuffer &out, std::string_view prefix) {
+  for (std::size_t i = 0; i < N; i++) {
+    out.Text(prefix);
+    out.Char('_');
+    out.Integer(i);
+    out.Char(',');
+  }
+}
+
+/** Coordinates, each followed by a comma. */
+template <std::size_t N>
+void csv_vector(OutputBuffer &out, const CMyVektor<N> &x) {
+  for (const double value : x) {
+    out.Number(value);
+    out.Char(',');
+  }
+}
+
+/** JSON has no NaN or infinity, they are written as null. */
+inline void json_value(OutputBuffer &out, double value) {
+  if (std::isfinite(value)) {
+    out.Number(value);
+  } else {
+    out.Text("null");
+  }
+}
+
+/** `"name":[x_0,...]` */
+template <std::size_t N>
+void json_vector(OutputBuffer &out, std::string_view name,
+                 const CMyVektor<N> &x) {
+  out.Char('"');
+  out.Text(name);
+  out.Text("\":[");
+  for (std::size_t i = 0; i < N; i++) {
+    if (i > 0) {
+      out.Char(',');
+    }
+    json_value(out, x[i]);
+  }
+  out.Char(']');
+}
+
+/** `"name":value` */
+inline void json_number(OutputBuffer &out, std::string_view name,
+                        double value) {
+  out.Char('"');
+  out.Text(name);
+  out.Text("\":");
+  json_value(out, value);
+}
+} // namespace writer_detail
+
+template <std::size_t N>
+IterationWriter<N>::IterationWriter(OutputBuffer &out, OutputFormat format)
+    : out(out), format(format) {
+  using namespace writer_detail;
+  if (format == OutputFormat::Csv) {
+    out.Text("index,step_size,");
+    csv_columns<N>(out, "x");
+    out.Text("value,");
+    csv_columns<N>(out, "grad");
+    out.Text("grad_norm,");
+    csv_columns<N>(out, "next");
+    out.Text("next_value,");
+    csv_columns<N>(out, "test");
+    out.Text("test_value\n");
+  } else if (format == OutputFormat::Binary) {
+    binary_header(out, RecordKind::Iteration, N);
+  }
+}
+
+template <std::size_t N>
+void IterationWriter<N>::Write(const IterationData<N> &iteration) {
+  using namespace writer_detail;
+  switch (format) {
+  case OutputFormat::Text: {
+    std::ostringstream ss;
+    ss << iteration << "\n";
+    out.Text(ss.str());
+    break;
+  }
+  case OutputFormat::Csv:
+    out.Integer(iteration.index);
+    out.Char(',');
+    out.Number(iteration.step_size);
+    out.Char(',');
+    csv_vector(out, iteration.current.vector);
+    out.Number(iteration.current.value);
+    out.Char(',');
+    csv_vector(out, iteration.current_grad);
+    out.Number(iteration.current_grad.norm());
+    out.Char(',');
+    csv_vector(out, iteration.next.vector);
+    out.Number(iteration.next.value);
+    out.Char(',');
+    csv_vector(out, iteration.test.vector);
+    out.Number(iteration.test.value);
+    out.Char('\n');
+    break;
+  case OutputFormat::JsonLines:
+    out.Text("{\"index\":");
+    out.Integer(iteration.index);
+    out.Char(',');
+    json_number(out, "step_size", iteration.step_size);
+    out.Char(',');
+    json_vector(out, "x", iteration.current.vector);
+    out.Char(',');
+    json_number(out, "value", iteration.current.value);
+    out.Char(',');
+    json_vector(out, "grad", iteration.current_grad);
+    out.Char(',');
+    json_number(out, "grad_norm", iteration.current_grad.norm());
+    out.Char(',');
+    json_vector(out, "next", iteration.next.vector);
+    out.Char(',');
+    json_number(out, "next_value", iteration.next.value);
+    out.Char(',');
+    json_vector(out, "test", iteration.test.vector);
+    out.Char(',');
+    json_number(out, "test_value", iteration.test.value);
+    out.Text("}\n");
+    break;
+  case OutputFormat::Binary: {
+    const uint64_t index = iteration.index;
+    record.clear();
+    protocol::EncodeIteration(iteration, record);
+    out.Raw(&index, sizeof(index));
+    out.Raw(record.data(), record.size());
+    break;
+  }
+  }
+}
+
+template <std::size_t N>
+ResultWriter<N>::ResultWriter(OutputBuffer &out, OutputFormat format)
+    : out(out), format(format) {
+  using namespace writer_detail;
+  if (format == OutputFormat::Csv) {
+    csv_columns<N>(out, "start");
+    csv_columns<N>(out, "end");
+    out.Text("value,gradient_norm,iterations,converged\n");
+  } else if (format == OutputFormat::Binary) {
+    binary_header(out, RecordKind::Result, N);
+  }
+}
+
+template <std::size_t N>
+void ResultWriter<N>::Write(const RunResult<N> &result) {
+  using namespace writer_detail;
+  switch (format) {
+  case OutputFormat::Text: {
+    char line[128];
+    out.Text("start (");
+    for (std::size_t i = 0; i < N; i++) {
+      std::snprintf(line, sizeof(line), i == 0 ? "%g" : ", %g",
+                    result.start[i]);
+      out.Text(line);
+    }
+    out.Text(") -> x (");
+    for (std::size_t i = 0; i < N; i++) {
+      std::snprintf(line, sizeof(line), i == 0 ? "%.10g" : ", %.10g",
+                    result.end.vector[i]);
+      out.Text(line);
+    }
+    std::snprintf(line, sizeof(line),
+                  "), f(x) = %.10g, ||grad f(x)|| = %.3g, %zu iterations, %s\n",
+                  result.end.value, result.gradient_norm, result.iterations,
+                  result.converged ? "converged" : "not converged");
+    out.Text(line);
+    break;
+  }
+  case OutputFormat::Csv:
+    csv_vector(out, result.start);
+    csv_vector(out, result.end.vector);
+    out.Number(result.end.value);
+    out.Char(',');
+    out.Number(result.gradient_norm);
+    out.Char(',');
+    out.Integer(result.iterations);
+    out.Char(',');
+    out.Char(result.converged ? '1' : '0');
+    out.Char('\n');
+    break;
+  case OutputFormat::JsonLines:
+    out.Char('{');
+    json_vector(out, "start", result.start);
+    out.Char(',');
+    json_vector(out, "x", result.end.vector);
+    out.Char(',');
+    json_number(out, "value", result.end.value);
+    out.Char(',');
+    json_number(out, "gradient_norm", result.gradient_norm);
+    out.Text(",\"iterations\":");
+    out.Integer(result.iterations);
+    out.Text(result.converged ? ",\"converged\":true}\n"
+                              : ",\"converged\":false}\n");
+    break;
+  case OutputFormat::Binary: {
+    double values[2 * N + 2];
+    double *it = std::copy(result.start.begin(), result.start.end(), values);
+    it = std::copy(result.end.vector.begin(), result.end.vector.end(), it);
+    *it++ = result.end.value;
+    *it++ = result.gradient_norm;
+    const uint64_t counts[2] = {result.iterations,
+                                result.converged ? uint64_t{1} : uint64_t{0}};
+    out.Raw(values, sizeof(values));
+    out.Raw(counts, sizeof(counts));
+    break;
+  }
+  }
+}
+
+#endif // WRITER_H_
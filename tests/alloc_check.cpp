@@ -0,0 +1,65 @@
+/**
+ * @file alloc_check.cpp
+ *
+ * @brief Test that the optimizer steps and steady-state replay frames do not
+ * allocate.
+ *
+ * Built with `PLOTTINGS_ALLOC_CHECK=2`, so the first allocation inside an
+ * allocation-free scope aborts and fails the test. Runs `gradient_descent`
+ * and `Optimize` in two and three dimensions and replays the input log given
+ * as the only argument.
+ *
+ *   plottings-alloc-check <input log>
+ *
+ * @author Johannes Schiffer
+ * @date 18-10-2026
+ */
+#include "batch.hpp"
+#include "functions.hpp"
+#include "input_log.hpp"
+#include "iteration.hpp"
+#include "replay.hpp"
+
+#include <cstdio>
+#include <exception>
+
+static_assert(PLOTTINGS_ALLOC_CHECK == 2,
+              "The test relies on aborting allocation checks");
+
+namespace {
+/** Start points of f and g with their task step sizes, including one far
+ * from any optimum. */
+constexpr CMyVektor<2> STARTS_F[] = {{0.2, -2.1}, {3.0, 3.0}, {-1.0, 0.5}};
+constexpr CMyVektor<3> STARTS_G[] = {{0.0, 0.0, 0.0}, {1.0, -1.0, 2.0}};
+constexpr double STEP_SIZE_F = 1.0;
+constexpr double STEP_SIZE_G = 0.1;
+
+template <std::size_t N, std::size_t S>
+void optimize_all(const CMyVektor<N> (&starts)[S], FunctionPtr<N> funktion,
+                  double step_size) {
+  for (const auto &start : starts) {
+    static_cast<void>(gradient_descent<N>(start, funktion, step_size,
+                                          [](const IterationData<N> &) {}));
+    static_cast<void>(Optimize<N>(start, funktion, step_size,
+                                  IterationData<N>::MAX_ITERATIONS));
+  }
+}
+} // namespace
+
+auto main(int argc, char **argv) -> int {
+  if (argc != 2) {
+    std::fputs("usage: plottings-alloc-check <input log>\n", stderr);
+    return 2;
+  }
+  try {
+    optimize_all(STARTS_F, functions::f, STEP_SIZE_F);
+    optimize_all(STARTS_G, functions::g, STEP_SIZE_G);
+    const FrameStats stats = Replay(InputLog::Load(argv[1]));
+    std::printf("replayed %zu frames, %zu events\n", stats.frames,
+                stats.events);
+  } catch (const std::exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}